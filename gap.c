@@ -0,0 +1,187 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (c) 2025 Andrea Cervesato <andrea.cervesato@mailbox.org>
+ */
+
+#include "gap.h"
+#include "vec.h"
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include <stdint.h>
+
+/* text is stored inside `buf` as [0, gap_start) followed by [gap_end, size) */
+struct str_gap_obj
+{
+	char *buf;
+	size_t gap_start;
+	size_t gap_end;
+};
+
+static inline size_t gap_size(const str_gap_t self)
+{
+	return self->gap_end - self->gap_start;
+}
+
+static bool gap_grow(str_gap_t self, const size_t count)
+{
+	size_t old_size = vec_count(self->buf);
+	size_t tail = old_size - self->gap_end;
+	size_t new_size = old_size;
+	char *buf;
+
+	if (count > SIZE_MAX - (old_size - gap_size(self)))
+		return false;
+
+	while (new_size - (old_size - gap_size(self)) < count) {
+		if (new_size > SIZE_MAX / 2)
+			return false;
+
+		new_size *= 2;
+	}
+
+	buf = vec_resize(self->buf, new_size);
+	if (!buf)
+		return false;
+
+	memmove(buf + new_size - tail, buf + self->gap_end, tail);
+
+	self->buf = buf;
+	self->gap_end = new_size - tail;
+
+	return true;
+}
+
+str_gap_t str_gap_new(const char *str)
+{
+	assert(str);
+
+	size_t len = strlen(str);
+	str_gap_t self;
+
+	self = malloc(sizeof(struct str_gap_obj));
+	if (!self)
+		return NULL;
+
+	/* start with a gap as big as the text */
+	self->buf = vec_new_len(sizeof(char), len ? len * 2 : VEC_INIT_CAPACITY);
+	if (!self->buf) {
+		free(self);
+		return NULL;
+	}
+
+	memcpy(self->buf, str, len);
+
+	self->gap_start = len;
+	self->gap_end = vec_count(self->buf);
+
+	return self;
+}
+
+void str_gap_free(str_gap_t self)
+{
+	assert(self);
+
+	vec_free(self->buf);
+	free(self);
+}
+
+size_t str_gap_length(const str_gap_t self)
+{
+	assert(self);
+
+	return vec_count(self->buf) - gap_size(self);
+}
+
+size_t str_gap_cursor(const str_gap_t self)
+{
+	assert(self);
+
+	return self->gap_start;
+}
+
+void str_gap_move(str_gap_t self, size_t pos)
+{
+	assert(self);
+
+	size_t len = str_gap_length(self);
+
+	if (pos > len)
+		pos = len;
+
+	if (pos < self->gap_start) {
+		size_t n = self->gap_start - pos;
+
+		memmove(self->buf + self->gap_end - n, self->buf + pos, n);
+		self->gap_start -= n;
+		self->gap_end -= n;
+	} else if (pos > self->gap_start) {
+		size_t n = pos - self->gap_start;
+
+		memmove(self->buf + self->gap_start, self->buf + self->gap_end, n);
+		self->gap_start += n;
+		self->gap_end += n;
+	}
+}
+
+bool str_gap_insert(str_gap_t self, const char *str)
+{
+	assert(self);
+	assert(str);
+
+	size_t len = strlen(str);
+
+	if (len > gap_size(self) && !gap_grow(self, len))
+		return false;
+
+	memcpy(self->buf + self->gap_start, str, len);
+	self->gap_start += len;
+
+	return true;
+}
+
+void str_gap_delete(str_gap_t self, size_t count)
+{
+	assert(self);
+
+	size_t after = vec_count(self->buf) - self->gap_end;
+
+	self->gap_end += count > after ? after : count;
+}
+
+void str_gap_backspace(str_gap_t self, size_t count)
+{
+	assert(self);
+
+	self->gap_start -= count > self->gap_start ? self->gap_start : count;
+}
+
+char str_gap_at(const str_gap_t self, const size_t pos)
+{
+	assert(self);
+
+	if (pos >= str_gap_length(self))
+		return '\0';
+
+	if (pos < self->gap_start)
+		return self->buf[pos];
+
+	return self->buf[pos + gap_size(self)];
+}
+
+str_t str_gap_to_str(const str_gap_t self)
+{
+	assert(self);
+
+	size_t tail = vec_count(self->buf) - self->gap_end;
+	str_t str;
+
+	str = str_new_len(str_gap_length(self));
+	if (!str)
+		return NULL;
+
+	memcpy(str, self->buf, self->gap_start);
+	memcpy(str + self->gap_start, self->buf + self->gap_end, tail);
+
+	return str;
+}
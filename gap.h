@@ -0,0 +1,97 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (c) 2025 Andrea Cervesato <andrea.cervesato@mailbox.org>
+ */
+
+#ifndef LIBVEST_GAP_H
+#define LIBVEST_GAP_H
+
+#include "str.h"
+#include <stddef.h>
+#include <stdbool.h>
+
+/** @brief A gap buffer string.
+ *
+ * A gap buffer keeps an unused area (the gap) at the cursor position, so
+ * that consecutive insertions and deletions at the cursor only touch the gap
+ * and cost O(1) amortized. Moving the cursor moves only the characters
+ * between the old and the new position.
+ */
+typedef struct str_gap_obj* str_gap_t;
+
+/** @brief Create a gap buffer from a C-string.
+ *
+ * The cursor is placed at the end of the text.
+ *
+ * @param str C-string to copy.
+ * @return New gap buffer.
+ */
+str_gap_t str_gap_new(const char *str);
+
+/** @brief Release the gap buffer memory. */
+void str_gap_free(str_gap_t self);
+
+/** @brief Return the length of the text.
+ *
+ * @param self Gap buffer object.
+ * @return Number of characters inside the gap buffer.
+ */
+size_t str_gap_length(const str_gap_t self) __attribute__((pure));
+
+/** @brief Return the cursor position.
+ *
+ * @param self Gap buffer object.
+ * @return Cursor position.
+ */
+size_t str_gap_cursor(const str_gap_t self) __attribute__((pure));
+
+/** @brief Move the cursor.
+ *
+ * If `pos` is bigger than the text length, the cursor is moved at the end.
+ *
+ * @param self Gap buffer object.
+ * @param pos New cursor position.
+ */
+void str_gap_move(str_gap_t self, size_t pos);
+
+/** @brief Insert a C-string at the cursor.
+ *
+ * The cursor is moved after the inserted text.
+ *
+ * @param self Gap buffer object.
+ * @param str C-string to insert.
+ * @return True on success. False if memory can't be allocated.
+ */
+bool str_gap_insert(str_gap_t self, const char *str);
+
+/** @brief Delete characters after the cursor.
+ *
+ * @param self Gap buffer object.
+ * @param count Number of characters to delete. It's clamped to the text end.
+ */
+void str_gap_delete(str_gap_t self, size_t count);
+
+/** @brief Delete characters before the cursor.
+ *
+ * @param self Gap buffer object.
+ * @param count Number of characters to delete. It's clamped to the text
+ *              beginning.
+ */
+void str_gap_backspace(str_gap_t self, size_t count);
+
+/** @brief Return the character at a specific position.
+ *
+ * @param self Gap buffer object.
+ * @param pos Position of the character.
+ * @return The character or '\0' if `pos` is out of the text.
+ */
+char str_gap_at(const str_gap_t self, const size_t pos) __attribute__((pure));
+
+/** @brief Convert a gap buffer into a contiguous string.
+ *
+ * @param self Gap buffer object.
+ * @return New string with the gap buffer text.
+ */
+str_t str_gap_to_str(const str_gap_t self);
+
+#endif
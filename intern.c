@@ -0,0 +1,234 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (c) 2025 Andrea Cervesato <andrea.cervesato@mailbox.org>
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "intern.h"
+#include "vec.h"
+#include "vec_priv.h"
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+
+/* minimum size of an arena block */
+#define BLOCK_SIZE (64 * 1024)
+
+/* initial number of table slots */
+#define TABLE_INIT_SIZE 64
+
+typedef struct block
+{
+	struct block *next;
+	size_t used;
+	size_t size;
+	uint8_t data[];
+} block_t;
+
+/*
+ * Tables are never modified after being replaced, and they are kept alive
+ * until the pool is released, so readers can keep probing an old table.
+ */
+typedef struct table
+{
+	struct table *next;
+	size_t mask;
+	str_t slots[];
+} table_t;
+
+struct str_intern_obj
+{
+	pthread_mutex_t lock;
+	table_t *table;
+	size_t count;
+	block_t *blocks;
+};
+
+static table_t *table_new(const size_t size)
+{
+	table_t *table = calloc(1, sizeof(table_t) + size * sizeof(str_t));
+	if (!table)
+		return NULL;
+
+	table->mask = size - 1;
+
+	return table;
+}
+
+static str_t table_find(const table_t *table, const str_t str,
+			const uint64_t hash)
+{
+	size_t len = str_length(str);
+
+	for (size_t i = (size_t)hash & table->mask; ; i = (i + 1) & table->mask) {
+		str_t cur = __atomic_load_n(&table->slots[i], __ATOMIC_ACQUIRE);
+
+		if (!cur)
+			return NULL;
+
+		if (str_length(cur) == len && str_hash(cur) == hash &&
+		    !memcmp(cur, str, len))
+			return cur;
+	}
+}
+
+static void table_add(table_t *table, const str_t str)
+{
+	size_t i = (size_t)str_hash(str) & table->mask;
+
+	while (table->slots[i])
+		i = (i + 1) & table->mask;
+
+	__atomic_store_n(&table->slots[i], str, __ATOMIC_RELEASE);
+}
+
+/* copy a string inside the arena, as a read-only vector */
+static str_t arena_add(str_intern_t self, const str_t str, const uint64_t hash)
+{
+	size_t len = str_length(str);
+	size_t need = sizeof(str_meta_t) + sizeof(vec_obj_t) + len + 1;
+	block_t *block = self->blocks;
+	str_meta_t *meta;
+	vec_obj_t *obj;
+
+	need = (need + sizeof(size_t) - 1) & ~(sizeof(size_t) - 1);
+
+	if (!block || block->size - block->used < need) {
+		size_t size = need > BLOCK_SIZE ? need : BLOCK_SIZE;
+
+		block = malloc(sizeof(block_t) + size);
+		if (!block)
+			return NULL;
+
+		block->used = 0;
+		block->size = size;
+		block->next = self->blocks;
+		self->blocks = block;
+	}
+
+	meta = (str_meta_t *)(block->data + block->used);
+	meta->hash = hash;
+	meta->refs = 1;
+
+	obj = (vec_obj_t *)(meta + 1);
+	obj->unit_size = sizeof(char);
+	obj->capacity = len + 1;
+	obj->count = len;
+	obj->flags = VEC_CACHE_HASH | VEC_FLAG_STATIC | VEC_FLAG_STR;
+
+	memcpy(obj->data, str, len);
+	obj->data[len] = '\0';
+
+	block->used += need;
+
+	return (str_t)obj->data;
+}
+
+str_intern_t str_intern_new(void)
+{
+	str_intern_t self = malloc(sizeof(struct str_intern_obj));
+	if (!self)
+		return NULL;
+
+	self->table = table_new(TABLE_INIT_SIZE);
+	if (!self->table) {
+		free(self);
+		return NULL;
+	}
+
+	pthread_mutex_init(&self->lock, NULL);
+	self->count = 0;
+	self->blocks = NULL;
+
+	return self;
+}
+
+void str_intern_free(str_intern_t self)
+{
+	assert(self);
+
+	while (self->table) {
+		table_t *next = self->table->next;
+		free(self->table);
+		self->table = next;
+	}
+
+	while (self->blocks) {
+		block_t *next = self->blocks->next;
+		free(self->blocks);
+		self->blocks = next;
+	}
+
+	pthread_mutex_destroy(&self->lock);
+	free(self);
+}
+
+size_t str_intern_count(const str_intern_t self)
+{
+	assert(self);
+
+	return __atomic_load_n(&self->count, __ATOMIC_RELAXED);
+}
+
+str_t str_intern_lookup(const str_intern_t self, const str_t str)
+{
+	assert(self);
+	assert(str);
+
+	table_t *table = __atomic_load_n(&self->table, __ATOMIC_ACQUIRE);
+
+	return table_find(table, str, str_hash(str));
+}
+
+str_t str_intern(str_intern_t self, const str_t str)
+{
+	assert(self);
+	assert(str);
+
+	uint64_t hash = str_hash(str);
+	table_t *table;
+	str_t found;
+
+	found = str_intern_lookup(self, str);
+	if (found)
+		return found;
+
+	pthread_mutex_lock(&self->lock);
+
+	/* another thread could have added it in the meantime */
+	table = self->table;
+	found = table_find(table, str, hash);
+	if (found)
+		goto exit;
+
+	/* keep the load factor below 1/2, so probing stays short */
+	if ((self->count + 1) * 2 > table->mask + 1) {
+		table_t *bigger = table_new((table->mask + 1) * 2);
+		if (!bigger)
+			goto exit;
+
+		for (size_t i = 0; i <= table->mask; i++) {
+			if (table->slots[i])
+				table_add(bigger, table->slots[i]);
+		}
+
+		bigger->next = table;
+		table = bigger;
+		__atomic_store_n(&self->table, table, __ATOMIC_RELEASE);
+	}
+
+	found = arena_add(self, str, hash);
+	if (!found)
+		goto exit;
+
+	table_add(table, found);
+	__atomic_store_n(&self->count, self->count + 1, __ATOMIC_RELAXED);
+
+exit:
+	pthread_mutex_unlock(&self->lock);
+
+	return found;
+}
@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (c) 2025 Andrea Cervesato <andrea.cervesato@mailbox.org>
+ */
+
+#ifndef LIBVEST_INTERN_H
+#define LIBVEST_INTERN_H
+
+#include "str.h"
+#include <stddef.h>
+
+/** @brief A pool of interned strings.
+ *
+ * The pool returns one canonical string for each distinct content, so that
+ * interned strings can be compared by pointer. Canonical strings are stored
+ * inside a contiguous arena owned by the pool and they are valid until
+ * `str_intern_free()`. They are shared strings: `str_free()` does nothing on
+ * them and string functions modify a copy of them.
+ *
+ * `str_intern()` can be called by multiple threads at once and
+ * `str_intern_lookup()` never takes a lock.
+ */
+typedef struct str_intern_obj* str_intern_t;
+
+/** @brief Create a new pool of interned strings.
+ *
+ * @return New pool.
+ */
+str_intern_t str_intern_new(void);
+
+/** @brief Release the pool memory, including all its interned strings. */
+void str_intern_free(str_intern_t self);
+
+/** @brief Return the number of strings inside the pool.
+ *
+ * @param self Pool object.
+ * @return Number of interned strings.
+ */
+size_t str_intern_count(const str_intern_t self);
+
+/** @brief Return the canonical string having the same content of a string.
+ *
+ * The canonical string is added to the pool if it doesn't exist yet.
+ *
+ * @param self Pool object.
+ * @param str The string.
+ * @return Canonical string or NULL if memory can't be allocated.
+ */
+str_t str_intern(str_intern_t self, const str_t str);
+
+/** @brief Search the canonical string having the same content of a string.
+ *
+ * This function doesn't take locks, so it scales with the number of reader
+ * threads.
+ *
+ * @param self Pool object.
+ * @param str The string.
+ * @return Canonical string or NULL if `str` has not been interned.
+ */
+str_t str_intern_lookup(const str_intern_t self, const str_t str);
+
+#endif
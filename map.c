@@ -0,0 +1,344 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (c) 2025 Andrea Cervesato <andrea.cervesato@mailbox.org>
+ */
+
+#include "map.h"
+#include "vec.h"
+#include "str.h"
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include <stdint.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/* number of slots probed at once */
+#define GROUP_SIZE 16
+
+/* metadata of slots that don't hold a key, the others hold 7 hash bits */
+#define CTRL_EMPTY 0x80
+#define CTRL_DELETED 0xfe
+
+struct map_obj
+{
+	size_t count;		/* number of keys */
+	size_t growth_left;	/* keys we can add before rehashing */
+	size_t mask;		/* number of slots - 1 */
+	uint8_t *ctrl;		/* slots metadata, first group mirrored at the end */
+	str_t *keys;		/* slots keys */
+	uint8_t *values;	/* slots values */
+};
+
+static inline size_t hash_pos(const uint64_t hash)
+{
+	return (size_t)(hash >> 7);
+}
+
+static inline uint8_t hash_tag(const uint64_t hash)
+{
+	return (uint8_t)(hash & 0x7f);
+}
+
+/* return a bitmask of the group slots having `tag` metadata */
+static inline uint32_t group_match(const uint8_t *group, const uint8_t tag)
+{
+#ifdef __SSE2__
+	__m128i ctrl = _mm_loadu_si128((const __m128i *)group);
+
+	return (uint32_t)_mm_movemask_epi8(
+		_mm_cmpeq_epi8(ctrl, _mm_set1_epi8((char)tag)));
+#else
+	uint32_t mask = 0;
+
+	for (uint32_t i = 0; i < GROUP_SIZE; i++)
+		mask |= (uint32_t)(group[i] == tag) << i;
+
+	return mask;
+#endif
+}
+
+/* return a bitmask of the group slots that don't hold a key */
+static inline uint32_t group_free(const uint8_t *group)
+{
+#ifdef __SSE2__
+	__m128i ctrl = _mm_loadu_si128((const __m128i *)group);
+
+	return (uint32_t)_mm_movemask_epi8(ctrl);
+#else
+	uint32_t mask = 0;
+
+	for (uint32_t i = 0; i < GROUP_SIZE; i++)
+		mask |= (uint32_t)(group[i] >> 7) << i;
+
+	return mask;
+#endif
+}
+
+static inline size_t slots_count(const map_t self)
+{
+	return self->mask + 1;
+}
+
+static inline void *slot_value(const map_t self, const size_t slot)
+{
+	return self->values + slot * vec_unit_size(self->values);
+}
+
+static inline void ctrl_set(map_t self, const size_t slot, const uint8_t ctrl)
+{
+	self->ctrl[slot] = ctrl;
+
+	/* keep the mirrored group in sync, so probing never wraps */
+	if (slot < GROUP_SIZE)
+		self->ctrl[slots_count(self) + slot] = ctrl;
+}
+
+static bool map_alloc(map_t self, const size_t unit_size, const size_t slots)
+{
+	self->ctrl = vec_new_len(sizeof(uint8_t), slots + GROUP_SIZE);
+	self->keys = vec_new_len(sizeof(str_t), slots);
+	self->values = vec_new_len(unit_size, slots);
+
+	if (!self->ctrl || !self->keys || !self->values) {
+		if (self->ctrl)
+			vec_free(self->ctrl);
+		if (self->keys)
+			vec_free(self->keys);
+		if (self->values)
+			vec_free(self->values);
+
+		return false;
+	}
+
+	memset(self->ctrl, CTRL_EMPTY, slots + GROUP_SIZE);
+
+	self->mask = slots - 1;
+	self->growth_left = slots - slots / 8;
+
+	return true;
+}
+
+/* find the slot of `key`, or SIZE_MAX if it's not inside the map */
+static size_t map_find(const map_t self, const str_t key, const uint64_t hash)
+{
+	size_t len = str_length(key);
+	size_t pos = hash_pos(hash) & self->mask;
+	uint8_t tag = hash_tag(hash);
+
+	for (size_t stride = GROUP_SIZE; ; stride += GROUP_SIZE) {
+		const uint8_t *group = self->ctrl + pos;
+		uint32_t match = group_match(group, tag);
+
+		while (match) {
+			size_t slot = (pos + (size_t)__builtin_ctz(match)) & self->mask;
+			str_t cur = self->keys[slot];
+
+			if (str_length(cur) == len && str_hash(cur) == hash &&
+			    !memcmp(cur, key, len))
+				return slot;
+
+			match &= match - 1;
+		}
+
+		if (group_match(group, CTRL_EMPTY))
+			return SIZE_MAX;
+
+		pos = (pos + stride) & self->mask;
+	}
+}
+
+/* find the first slot that doesn't hold a key for `hash` */
+static size_t map_find_free(const map_t self, const uint64_t hash)
+{
+	size_t pos = hash_pos(hash) & self->mask;
+
+	for (size_t stride = GROUP_SIZE; ; stride += GROUP_SIZE) {
+		uint32_t mask = group_free(self->ctrl + pos);
+
+		if (mask)
+			return (pos + (size_t)__builtin_ctz(mask)) & self->mask;
+
+		pos = (pos + stride) & self->mask;
+	}
+}
+
+static bool map_rehash(map_t self)
+{
+	struct map_obj old = *self;
+	size_t unit_size = vec_unit_size(self->values);
+	size_t slots = slots_count(self);
+
+	/* grow only when tombstones are not the reason of a full table */
+	if (self->count >= slots / 2) {
+		if (slots > SIZE_MAX / 2)
+			return false;
+
+		slots *= 2;
+	}
+
+	if (!map_alloc(self, unit_size, slots)) {
+		*self = old;
+		return false;
+	}
+
+	for (size_t i = 0; i < slots_count(&old); i++) {
+		if (old.ctrl[i] & 0x80)
+			continue;
+
+		uint64_t hash = str_hash(old.keys[i]);
+		size_t slot = map_find_free(self, hash);
+
+		ctrl_set(self, slot, hash_tag(hash));
+		self->keys[slot] = old.keys[i];
+		memcpy(slot_value(self, slot), slot_value(&old, i), unit_size);
+	}
+
+	self->growth_left -= self->count;
+
+	vec_free(old.ctrl);
+	vec_free(old.keys);
+	vec_free(old.values);
+
+	return true;
+}
+
+map_t map_new(const size_t unit_size)
+{
+	map_t self = malloc(sizeof(struct map_obj));
+	if (!self)
+		return NULL;
+
+	self->count = 0;
+
+	if (!map_alloc(self, unit_size, GROUP_SIZE)) {
+		free(self);
+		return NULL;
+	}
+
+	return self;
+}
+
+void map_free(map_t self)
+{
+	assert(self);
+
+	for (size_t i = 0; i < slots_count(self); i++) {
+		if (!(self->ctrl[i] & 0x80))
+			str_free(self->keys[i]);
+	}
+
+	vec_free(self->ctrl);
+	vec_free(self->keys);
+	vec_free(self->values);
+	free(self);
+}
+
+size_t map_count(const map_t self)
+{
+	assert(self);
+
+	return self->count;
+}
+
+bool map_set(map_t self, const str_t key, const void *value)
+{
+	assert(self);
+	assert(key);
+	assert(value);
+
+	uint64_t hash = str_hash(key);
+	size_t len = str_length(key);
+	size_t slot;
+	str_t copy;
+
+	slot = map_find(self, key, hash);
+	if (slot != SIZE_MAX) {
+		memcpy(slot_value(self, slot), value,
+		       vec_unit_size(self->values));
+		return true;
+	}
+
+	slot = map_find_free(self, hash);
+	if (self->ctrl[slot] == CTRL_EMPTY && !self->growth_left) {
+		if (!map_rehash(self))
+			return false;
+
+		slot = map_find_free(self, hash);
+	}
+
+	copy = str_new_len(len);
+	if (!copy)
+		return false;
+
+	memcpy(copy, key, len);
+
+	/* cache the hash inside the copy, since rehashing needs it */
+	str_hash(copy);
+
+	if (self->ctrl[slot] == CTRL_EMPTY)
+		self->growth_left--;
+
+	ctrl_set(self, slot, hash_tag(hash));
+	self->keys[slot] = copy;
+	memcpy(slot_value(self, slot), value, vec_unit_size(self->values));
+	self->count++;
+
+	return true;
+}
+
+void *map_get(const map_t self, const str_t key)
+{
+	assert(self);
+	assert(key);
+
+	size_t slot = map_find(self, key, str_hash(key));
+	if (slot == SIZE_MAX)
+		return NULL;
+
+	return slot_value(self, slot);
+}
+
+bool map_remove(map_t self, const str_t key)
+{
+	assert(self);
+	assert(key);
+
+	size_t slot = map_find(self, key, str_hash(key));
+	if (slot == SIZE_MAX)
+		return false;
+
+	str_free(self->keys[slot]);
+	self->keys[slot] = NULL;
+
+	ctrl_set(self, slot, CTRL_DELETED);
+	self->count--;
+
+	return true;
+}
+
+bool map_next(const map_t self, size_t *iter, str_t *key, void **value)
+{
+	assert(self);
+	assert(iter);
+
+	for (size_t i = *iter; i < slots_count(self); i++) {
+		if (self->ctrl[i] & 0x80)
+			continue;
+
+		if (key)
+			*key = self->keys[i];
+		if (value)
+			*value = slot_value(self, i);
+
+		*iter = i + 1;
+
+		return true;
+	}
+
+	*iter = slots_count(self);
+
+	return false;
+}
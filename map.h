@@ -0,0 +1,84 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (c) 2025 Andrea Cervesato <andrea.cervesato@mailbox.org>
+ */
+
+#ifndef LIBVEST_MAP_H
+#define LIBVEST_MAP_H
+
+#include "str.h"
+#include <stddef.h>
+#include <stdbool.h>
+
+/** @brief An abstract hash map.
+ *
+ * A map associates string keys to values of the same size. Keys, values and
+ * the probing metadata are stored inside flat vectors, using open addressing
+ * with one metadata byte for each slot, so that a group of slots can be
+ * probed at once.
+ */
+typedef struct map_obj* map_t;
+
+/** @brief Create a new map.
+ *
+ * @param unit_size Size of a single value.
+ * @return New map.
+ */
+map_t map_new(const size_t unit_size);
+
+/** @brief Release the map memory, including keys and values. */
+void map_free(map_t self);
+
+/** @brief Return the number of keys inside the map.
+ *
+ * @param self Map object.
+ * @return Number of keys inside the map.
+ */
+size_t map_count(const map_t self) __attribute__((pure));
+
+/** @brief Set the value of a key.
+ *
+ * Copy `key` and the memory of `value` inside the map. If `key` is already
+ * present, its value is overwritten. Pointers returned by `map_get()` are
+ * invalidated when a new key is added.
+ *
+ * @param self Map object.
+ * @param key The key.
+ * @param value Pointer to the value.
+ * @return True on success. False if memory can't be allocated.
+ */
+bool map_set(map_t self, const str_t key, const void *value);
+
+/** @brief Return the value of a key.
+ *
+ * The key hash is taken from `str_hash()`, so looking up the same string
+ * multiple times doesn't hash it again.
+ *
+ * @param self Map object.
+ * @param key The key.
+ * @return Pointer to the value or NULL if `key` is not inside the map.
+ */
+void *map_get(const map_t self, const str_t key);
+
+/** @brief Remove a key and its value.
+ *
+ * @param self Map object.
+ * @param key The key.
+ * @return True if `key` was inside the map. False otherwise.
+ */
+bool map_remove(map_t self, const str_t key);
+
+/** @brief Iterate over the map items.
+ *
+ * Items are visited in no particular order. `iter` must be set to 0 before
+ * the first call and the map must not be modified during the iteration.
+ *
+ * @param self Map object.
+ * @param iter Iterator position.
+ * @param key If not NULL, it's set to the item key.
+ * @param value If not NULL, it's set to the pointer of the item value.
+ * @return True if an item has been found. False at the end of the map.
+ */
+bool map_next(const map_t self, size_t *iter, str_t *key, void **value);
+
+#endif
@@ -0,0 +1,579 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (c) 2025 Andrea Cervesato <andrea.cervesato@mailbox.org>
+ */
+
+#include "rope.h"
+#include "vec.h"
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include <stdint.h>
+
+/*
+ * The rope is an AVL tree: leaves hold up to ROPE_LEAF_SIZE bytes inside a
+ * string and internal nodes hold the total length of their subtree.
+ *
+ * Every edit is a sequence of split and join operations. Before modifying
+ * the tree, we reserve all the nodes that joins could need and we cut the
+ * leaf at the edit position, so the edit itself can't fail half-way.
+ */
+typedef struct node
+{
+	struct node *left;
+	struct node *right;
+	size_t length;
+	size_t height;
+	str_t leaf;
+} node_t;
+
+struct str_rope_obj
+{
+	node_t *root;
+	node_t *spare;		/* reserved nodes, linked by `left` */
+	size_t spare_count;
+};
+
+static inline size_t node_height(const node_t *node)
+{
+	return node ? node->height : 0;
+}
+
+static inline size_t node_length(const node_t *node)
+{
+	return node ? node->length : 0;
+}
+
+static inline void node_update(node_t *node)
+{
+	size_t hl = node_height(node->left);
+	size_t hr = node_height(node->right);
+
+	node->length = node_length(node->left) + node_length(node->right);
+	node->height = 1 + (hl > hr ? hl : hr);
+}
+
+static node_t *node_leaf(const char *str, const size_t len)
+{
+	node_t *node = malloc(sizeof(node_t));
+	if (!node)
+		return NULL;
+
+	node->leaf = str_new_len(len);
+	if (!node->leaf) {
+		free(node);
+		return NULL;
+	}
+
+	memcpy(node->leaf, str, len);
+
+	node->left = NULL;
+	node->right = NULL;
+	node->length = len;
+	node->height = 1;
+
+	return node;
+}
+
+static void node_free(node_t *node)
+{
+	if (!node)
+		return;
+
+	if (node->leaf) {
+		str_free(node->leaf);
+	} else {
+		node_free(node->left);
+		node_free(node->right);
+	}
+
+	free(node);
+}
+
+static bool spare_reserve(str_rope_t self, const size_t count)
+{
+	while (self->spare_count < count) {
+		node_t *node = malloc(sizeof(node_t));
+		if (!node)
+			return false;
+
+		node->left = self->spare;
+		self->spare = node;
+		self->spare_count++;
+	}
+
+	return true;
+}
+
+static void spare_trim(str_rope_t self, const size_t count)
+{
+	while (self->spare_count > count) {
+		node_t *node = self->spare;
+
+		self->spare = node->left;
+		self->spare_count--;
+		free(node);
+	}
+}
+
+static node_t *spare_take(str_rope_t self)
+{
+	node_t *node = self->spare;
+
+	assert(node);
+
+	self->spare = node->left;
+	self->spare_count--;
+
+	return node;
+}
+
+static void spare_put(str_rope_t self, node_t *node)
+{
+	node->left = self->spare;
+	self->spare = node;
+	self->spare_count++;
+}
+
+/* nodes that a single edit could need */
+static inline size_t spare_needed(const str_rope_t self)
+{
+	return 4 * (node_height(self->root) + 2);
+}
+
+static node_t *rotate_left(node_t *node)
+{
+	node_t *right = node->right;
+
+	node->right = right->left;
+	node_update(node);
+
+	right->left = node;
+	node_update(right);
+
+	return right;
+}
+
+static node_t *rotate_right(node_t *node)
+{
+	node_t *left = node->left;
+
+	node->left = left->right;
+	node_update(node);
+
+	left->right = node;
+	node_update(left);
+
+	return left;
+}
+
+static node_t *node_balance(node_t *node)
+{
+	size_t hl = node_height(node->left);
+	size_t hr = node_height(node->right);
+
+	if (hl > hr + 1) {
+		if (node_height(node->left->right) > node_height(node->left->left))
+			node->left = rotate_left(node->left);
+
+		return rotate_right(node);
+	}
+
+	if (hr > hl + 1) {
+		if (node_height(node->right->left) > node_height(node->right->right))
+			node->right = rotate_right(node->right);
+
+		return rotate_left(node);
+	}
+
+	return node;
+}
+
+static node_t *node_join(str_rope_t self, node_t *left, node_t *right)
+{
+	size_t hl;
+	size_t hr;
+	node_t *node;
+
+	if (!left)
+		return right;
+
+	if (!right)
+		return left;
+
+	/* merge small leaves, so leaves don't get fragmented by edits */
+	if (left->leaf && right->leaf &&
+	    left->length + right->length <= ROPE_LEAF_SIZE) {
+		str_t merged = vec_resize(left->leaf, left->length + right->length);
+
+		if (merged) {
+			memcpy(merged + left->length, right->leaf, right->length);
+
+			left->leaf = merged;
+			left->length += right->length;
+
+			str_free(right->leaf);
+			spare_put(self, right);
+
+			return left;
+		}
+	}
+
+	hl = node_height(left);
+	hr = node_height(right);
+
+	if (hl > hr + 1) {
+		left->right = node_join(self, left->right, right);
+		node_update(left);
+		return node_balance(left);
+	}
+
+	if (hr > hl + 1) {
+		right->left = node_join(self, left, right->left);
+		node_update(right);
+		return node_balance(right);
+	}
+
+	node = spare_take(self);
+	node->leaf = NULL;
+	node->left = left;
+	node->right = right;
+	node_update(node);
+
+	return node;
+}
+
+/* split a tree at `pos`, which must be at the boundary of a leaf */
+static void node_split(str_rope_t self, node_t *node, const size_t pos,
+		       node_t **left, node_t **right)
+{
+	node_t *a;
+	node_t *b;
+	node_t *l;
+	node_t *r;
+
+	if (!node || !pos) {
+		*left = NULL;
+		*right = node;
+		return;
+	}
+
+	if (pos >= node->length) {
+		*left = node;
+		*right = NULL;
+		return;
+	}
+
+	assert(!node->leaf);
+
+	l = node->left;
+	r = node->right;
+	spare_put(self, node);
+
+	if (pos <= l->length) {
+		node_split(self, l, pos, &a, &b);
+		*left = a;
+		*right = node_join(self, b, r);
+	} else {
+		node_split(self, r, pos - l->length, &a, &b);
+		*left = node_join(self, l, a);
+		*right = b;
+	}
+}
+
+/* cut the leaf containing `pos`, returning the new root in `node` */
+static bool node_cut(str_rope_t self, node_t **node, const size_t pos)
+{
+	node_t *cur = *node;
+
+	if (!cur || !pos || pos >= cur->length)
+		return true;
+
+	if (cur->leaf) {
+		node_t *head = spare_take(self);
+		node_t *tail = node_leaf(cur->leaf + pos, cur->length - pos);
+
+		if (!tail) {
+			spare_put(self, head);
+			return false;
+		}
+
+		/* shrinking never triggers realloc */
+		head->leaf = vec_resize(cur->leaf, pos);
+		head->left = NULL;
+		head->right = NULL;
+		head->length = pos;
+		head->height = 1;
+
+		cur->leaf = NULL;
+		cur->left = head;
+		cur->right = tail;
+		node_update(cur);
+
+		return true;
+	}
+
+	if (pos < cur->left->length) {
+		if (!node_cut(self, &cur->left, pos))
+			return false;
+	} else {
+		if (!node_cut(self, &cur->right, pos - cur->left->length))
+			return false;
+	}
+
+	node_update(cur);
+	*node = node_balance(cur);
+
+	return true;
+}
+
+/* build a balanced tree from a string */
+static node_t *node_build(const char *str, const size_t len)
+{
+	size_t leaves;
+	size_t half;
+	node_t *node;
+
+	if (!len)
+		return NULL;
+
+	if (len <= ROPE_LEAF_SIZE)
+		return node_leaf(str, len);
+
+	leaves = (len + ROPE_LEAF_SIZE - 1) / ROPE_LEAF_SIZE;
+	half = (leaves / 2) * ROPE_LEAF_SIZE;
+
+	node = malloc(sizeof(node_t));
+	if (!node)
+		return NULL;
+
+	node->leaf = NULL;
+	node->left = node_build(str, half);
+	node->right = node_build(str + half, len - half);
+
+	if (!node->left || !node->right) {
+		node_free(node->left);
+		node_free(node->right);
+		free(node);
+		return NULL;
+	}
+
+	node_update(node);
+
+	return node;
+}
+
+static void node_flatten(const node_t *node, char *out)
+{
+	if (!node)
+		return;
+
+	if (node->leaf) {
+		memcpy(out, node->leaf, node->length);
+		return;
+	}
+
+	node_flatten(node->left, out);
+	node_flatten(node->right, out + node->left->length);
+}
+
+str_rope_t str_rope_new(void)
+{
+	str_rope_t self = malloc(sizeof(struct str_rope_obj));
+	if (!self)
+		return NULL;
+
+	self->root = NULL;
+	self->spare = NULL;
+	self->spare_count = 0;
+
+	return self;
+}
+
+str_rope_t str_rope_new_str(const char *str)
+{
+	assert(str);
+
+	str_rope_t self = str_rope_new();
+	if (!self)
+		return NULL;
+
+	if (!str_rope_append(self, str)) {
+		str_rope_free(self);
+		return NULL;
+	}
+
+	return self;
+}
+
+void str_rope_free(str_rope_t self)
+{
+	assert(self);
+
+	node_free(self->root);
+	spare_trim(self, 0);
+	free(self);
+}
+
+size_t str_rope_length(const str_rope_t self)
+{
+	assert(self);
+
+	return node_length(self->root);
+}
+
+bool str_rope_insert(str_rope_t self, const size_t pos, const char *str)
+{
+	assert(self);
+	assert(str);
+
+	node_t *mid;
+	node_t *left;
+	node_t *right;
+
+	if (pos > str_rope_length(self))
+		return false;
+
+	if (!*str)
+		return true;
+
+	if (!spare_reserve(self, spare_needed(self)))
+		return false;
+
+	mid = node_build(str, strlen(str));
+	if (!mid)
+		return false;
+
+	if (!node_cut(self, &self->root, pos)) {
+		node_free(mid);
+		return false;
+	}
+
+	node_split(self, self->root, pos, &left, &right);
+	self->root = node_join(self, node_join(self, left, mid), right);
+
+	spare_trim(self, spare_needed(self));
+
+	return true;
+}
+
+bool str_rope_append(str_rope_t self, const char *str)
+{
+	return str_rope_insert(self, str_rope_length(self), str);
+}
+
+bool str_rope_remove(str_rope_t self, const size_t pos, size_t len)
+{
+	assert(self);
+
+	size_t total = str_rope_length(self);
+	node_t *left;
+	node_t *mid;
+	node_t *right;
+
+	if (pos >= total || !len)
+		return true;
+
+	if (len > total - pos)
+		len = total - pos;
+
+	if (!spare_reserve(self, spare_needed(self)))
+		return false;
+
+	if (!node_cut(self, &self->root, pos))
+		return false;
+
+	/* joins can merge leaves, so the second cut comes after the split */
+	node_split(self, self->root, pos, &left, &mid);
+
+	if (!node_cut(self, &mid, len)) {
+		self->root = node_join(self, left, mid);
+		return false;
+	}
+
+	node_split(self, mid, len, &mid, &right);
+	node_free(mid);
+
+	self->root = node_join(self, left, right);
+
+	spare_trim(self, spare_needed(self));
+
+	return true;
+}
+
+bool str_rope_concat(str_rope_t self, str_rope_t other)
+{
+	assert(self);
+	assert(other);
+
+	if (!spare_reserve(self, spare_needed(self)))
+		return false;
+
+	self->root = node_join(self, self->root, other->root);
+	other->root = NULL;
+
+	spare_trim(self, spare_needed(self));
+
+	return true;
+}
+
+char str_rope_at(const str_rope_t self, size_t pos)
+{
+	assert(self);
+
+	const node_t *node = self->root;
+
+	if (pos >= node_length(node))
+		return '\0';
+
+	while (!node->leaf) {
+		if (pos < node->left->length) {
+			node = node->left;
+		} else {
+			pos -= node->left->length;
+			node = node->right;
+		}
+	}
+
+	return node->leaf[pos];
+}
+
+const char *str_rope_next(const str_rope_t self, size_t *iter, size_t *len)
+{
+	assert(self);
+	assert(iter);
+	assert(len);
+
+	const node_t *node = self->root;
+	size_t pos = *iter;
+
+	if (pos >= node_length(node))
+		return NULL;
+
+	while (!node->leaf) {
+		if (pos < node->left->length) {
+			node = node->left;
+		} else {
+			pos -= node->left->length;
+			node = node->right;
+		}
+	}
+
+	*len = node->length - pos;
+	*iter += *len;
+
+	return node->leaf + pos;
+}
+
+str_t str_rope_flatten(const str_rope_t self)
+{
+	assert(self);
+
+	str_t str = str_new_len(str_rope_length(self));
+	if (!str)
+		return NULL;
+
+	node_flatten(self->root, str);
+
+	return str;
+}
@@ -0,0 +1,115 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (c) 2025 Andrea Cervesato <andrea.cervesato@mailbox.org>
+ */
+
+#ifndef LIBVEST_ROPE_H
+#define LIBVEST_ROPE_H
+
+#include "str.h"
+#include <stddef.h>
+#include <stdbool.h>
+
+/** @brief Maximum number of bytes stored inside a single rope leaf. */
+#define ROPE_LEAF_SIZE 512
+
+/** @brief A rope of characters.
+ *
+ * A rope stores a large text as a balanced tree of string chunks, so that
+ * insertions, deletions and concatenations cost O(log n) instead of moving
+ * the whole text.
+ */
+typedef struct str_rope_obj* str_rope_t;
+
+/** @brief Create an empty rope.
+ *
+ * @return New rope.
+ */
+str_rope_t str_rope_new(void);
+
+/** @brief Create a rope from a C-string.
+ *
+ * @param str C-string to copy.
+ * @return New rope.
+ */
+str_rope_t str_rope_new_str(const char *str);
+
+/** @brief Release the rope memory. */
+void str_rope_free(str_rope_t self);
+
+/** @brief Return the length of a rope.
+ *
+ * @param self Rope object.
+ * @return Number of characters inside the rope.
+ */
+size_t str_rope_length(const str_rope_t self) __attribute__((pure));
+
+/** @brief Insert a C-string in a specific position of a rope.
+ *
+ * @param self Rope object.
+ * @param pos Position where we want to insert the C-string.
+ * @param str C-string to insert.
+ * @return True on success. False if `pos` is out of the rope or memory can't
+ *         be allocated.
+ */
+bool str_rope_insert(str_rope_t self, const size_t pos, const char *str);
+
+/** @brief Append a C-string to a rope.
+ *
+ * @param self Rope object.
+ * @param str C-string to add.
+ * @return True on success. False if memory can't be allocated.
+ */
+bool str_rope_append(str_rope_t self, const char *str);
+
+/** @brief Remove a range of characters from a rope.
+ *
+ * Remove `len` characters starting from `pos`. The range is clamped to the
+ * rope length.
+ *
+ * @param self Rope object.
+ * @param pos Position of the first character to remove.
+ * @param len Number of characters to remove.
+ * @return True on success. False if memory can't be allocated.
+ */
+bool str_rope_remove(str_rope_t self, const size_t pos, size_t len);
+
+/** @brief Move the content of a rope at the end of another rope.
+ *
+ * `other` is emptied, but it still needs to be released.
+ *
+ * @param self Rope object.
+ * @param other Rope to append.
+ * @return True on success. False if memory can't be allocated.
+ */
+bool str_rope_concat(str_rope_t self, str_rope_t other);
+
+/** @brief Return the character at a specific position.
+ *
+ * @param self Rope object.
+ * @param pos Position of the character.
+ * @return The character or '\0' if `pos` is out of the rope.
+ */
+char str_rope_at(const str_rope_t self, size_t pos) __attribute__((pure));
+
+/** @brief Iterate over the rope chunks.
+ *
+ * Chunks are visited in order and they are not terminated. `iter` must be set
+ * to 0 before the first call and the rope must not be modified during the
+ * iteration.
+ *
+ * @param self Rope object.
+ * @param iter Iterator position.
+ * @param len Set to the number of bytes inside the chunk.
+ * @return Pointer to the chunk or NULL at the end of the rope.
+ */
+const char *str_rope_next(const str_rope_t self, size_t *iter, size_t *len);
+
+/** @brief Convert a rope into a string.
+ *
+ * @param self Rope object.
+ * @return New string with the rope content.
+ */
+str_t str_rope_flatten(const str_rope_t self);
+
+#endif
@@ -5,16 +5,69 @@
 
 #include "str.h"
 #include "vec.h"
+#include "vec_priv.h"
+#include "vec_pool.h"
 #include <stdio.h>
 #include <assert.h>
 #include <string.h>
 #include <stdarg.h>
 #include <stdint.h>
+#include <stdlib.h>
+#include <errno.h>
 
 #define BUFSIZE 64
 
+/* minimum number of bytes searched by a str_find_parallel() chunk */
+#define FIND_CHUNK_MIN (64 * 1024)
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define HAVE_AVX2 1
+#endif
+
+/*
+ * make sure we are the only owner of a string before modifying it. A shared
+ * string is copied into a private one already sized to size bytes plus the
+ * terminator, and the original reference is dropped only once the copy
+ * exists, so on failure the caller still owns self.
+ */
+static str_t str_detach(str_t self, const size_t size)
+{
+	vec_obj_t *obj = vec_object(self);
+	size_t count = obj->count < size ? obj->count : size;
+	str_t copy;
+
+	if (!(vec_flags(obj) & VEC_FLAG_STATIC) &&
+	    __atomic_load_n(&str_meta(obj)->refs, __ATOMIC_ACQUIRE) == 1)
+		return self;
+
+	if (size == SIZE_MAX)
+		return NULL;
+
+	copy = str_new_len(size + 1);
+	if (!copy)
+		return NULL;
+
+	memcpy(copy, self, count);
+
+	/* Shrinking never triggers realloc, so this cannot fail */
+	copy = vec_resize(copy, size);
+
+	str_unref(self);
+
+	return copy;
+}
+
 static str_t str_resize(str_t self, const size_t size)
 {
+	str_t copy = str_detach(self, size);
+	if (!copy)
+		return NULL;
+
+	/* a detached copy is already sized and terminated */
+	if (copy != self)
+		return copy;
+
 	self = vec_resize(self, size + 1);
 	if (!self)
 		return NULL;
@@ -38,12 +91,12 @@ static str_t str_extend(str_t self, const size_t count)
 
 str_t str_empty(void)
 {
-	return vec_new(sizeof(char));
+	return str_new_len(0);
 }
 
 str_t str_new_len(const size_t count)
 {
-	return vec_new_len(sizeof(char), count);
+	return vec_new_flags(sizeof(char), count, VEC_FLAG_STR);
 }
 
 str_t str_new(const char *str)
@@ -62,7 +115,36 @@ str_t str_new(const char *str)
 
 void str_free(str_t self)
 {
-	vec_free(self);
+	str_unref(self);
+}
+
+str_t str_ref(str_t self)
+{
+	vec_obj_t *obj = vec_object(self);
+
+	if (!(vec_flags(obj) & VEC_FLAG_STATIC))
+		__atomic_add_fetch(&str_meta(obj)->refs, 1, __ATOMIC_RELAXED);
+
+	return self;
+}
+
+void str_unref(str_t self)
+{
+	vec_obj_t *obj = vec_object(self);
+
+	if (vec_flags(obj) & VEC_FLAG_STATIC)
+		return;
+
+	if (!__atomic_sub_fetch(&str_meta(obj)->refs, 1, __ATOMIC_ACQ_REL))
+		vec_free(self);
+}
+
+bool str_is_shared(const str_t self)
+{
+	vec_obj_t *obj = vec_object(self);
+
+	return (vec_flags(obj) & VEC_FLAG_STATIC) ||
+		__atomic_load_n(&str_meta(obj)->refs, __ATOMIC_ACQUIRE) > 1;
 }
 
 size_t str_length(const str_t self)
@@ -70,213 +152,1615 @@ size_t str_length(const str_t self)
 	return vec_count(self);
 }
 
-str_t str_insert(str_t self, const size_t pos, const char *str)
+static bool utf8_valid_scalar(const uint8_t *s, const size_t len)
 {
-	assert(self);
-	assert(str);
+	size_t i = 0;
 
-	size_t old_len = str_length(self);
+	while (i < len) {
+		uint32_t cp;
+		uint32_t min;
+		size_t n;
 
-	if (pos > old_len)
-		return NULL;
+		if (s[i] < 0x80) {
+			i++;
+			continue;
+		}
 
-	size_t str_len = strlen(str);
+		if ((s[i] & 0xe0) == 0xc0) {
+			n = 1;
+			cp = s[i] & 0x1f;
+			min = 0x80;
+		} else if ((s[i] & 0xf0) == 0xe0) {
+			n = 2;
+			cp = s[i] & 0x0f;
+			min = 0x800;
+		} else if ((s[i] & 0xf8) == 0xf0) {
+			n = 3;
+			cp = s[i] & 0x07;
+			min = 0x10000;
+		} else {
+			return false;
+		}
 
-	self = str_extend(self, str_len);
-	if (!self)
-		return NULL;
+		if (len - i - 1 < n)
+			return false;
 
-	vec_copy(self, pos + str_len, vec_ptr_at(self, pos), old_len - pos);
-	vec_copy(self, pos, str, str_len);
+		for (size_t k = 1; k <= n; k++) {
+			if ((s[i + k] & 0xc0) != 0x80)
+				return false;
 
-	return self;
+			cp = (cp << 6) | (s[i + k] & 0x3f);
+		}
+
+		if (cp < min || cp > 0x10ffff || (cp >= 0xd800 && cp <= 0xdfff))
+			return false;
+
+		i += n + 1;
+	}
+
+	return true;
 }
 
-str_t str_append(str_t self, const char *str)
+static size_t utf8_length_scalar(const uint8_t *s, const size_t len)
 {
-	return str_insert(self, str_length(self), str);
+	size_t count = 0;
+
+	for (size_t i = 0; i < len; i++)
+		count += (s[i] & 0xc0) != 0x80;
+
+	return count;
 }
 
-str_t str_clear(str_t self)
+#ifdef HAVE_AVX2
+/*
+ * Lookup tables of the Keiser-Lemire validation algorithm. Each byte pair is
+ * classified by the high nibble of the first byte, the low nibble of the
+ * first byte and the high nibble of the second byte: the pair is invalid when
+ * the three classifications share a bit.
+ */
+#define U8_TOO_SHORT	(1 << 0)
+#define U8_TOO_LONG	(1 << 1)
+#define U8_OVERLONG_3	(1 << 2)
+#define U8_TOO_LARGE	(1 << 3)
+#define U8_SURROGATE	(1 << 4)
+#define U8_OVERLONG_2	(1 << 5)
+#define U8_TOO_LARGE_1000 (1 << 6)
+#define U8_OVERLONG_4	(1 << 6)
+#define U8_TWO_CONTS	(1 << 7)
+#define U8_CARRY	(U8_TOO_SHORT | U8_TOO_LONG | U8_TWO_CONTS)
+
+static const uint8_t utf8_byte_1_high[16] = {
+	U8_TOO_LONG, U8_TOO_LONG, U8_TOO_LONG, U8_TOO_LONG,
+	U8_TOO_LONG, U8_TOO_LONG, U8_TOO_LONG, U8_TOO_LONG,
+	U8_TWO_CONTS, U8_TWO_CONTS, U8_TWO_CONTS, U8_TWO_CONTS,
+	U8_TOO_SHORT | U8_OVERLONG_2,
+	U8_TOO_SHORT,
+	U8_TOO_SHORT | U8_OVERLONG_3 | U8_SURROGATE,
+	U8_TOO_SHORT | U8_TOO_LARGE | U8_TOO_LARGE_1000 | U8_OVERLONG_4,
+};
+
+static const uint8_t utf8_byte_1_low[16] = {
+	U8_CARRY | U8_OVERLONG_3 | U8_OVERLONG_2 | U8_OVERLONG_4,
+	U8_CARRY | U8_OVERLONG_2,
+	U8_CARRY,
+	U8_CARRY,
+	U8_CARRY | U8_TOO_LARGE,
+	U8_CARRY | U8_TOO_LARGE | U8_TOO_LARGE_1000,
+	U8_CARRY | U8_TOO_LARGE | U8_TOO_LARGE_1000,
+	U8_CARRY | U8_TOO_LARGE | U8_TOO_LARGE_1000,
+	U8_CARRY | U8_TOO_LARGE | U8_TOO_LARGE_1000,
+	U8_CARRY | U8_TOO_LARGE | U8_TOO_LARGE_1000,
+	U8_CARRY | U8_TOO_LARGE | U8_TOO_LARGE_1000,
+	U8_CARRY | U8_TOO_LARGE | U8_TOO_LARGE_1000,
+	U8_CARRY | U8_TOO_LARGE | U8_TOO_LARGE_1000,
+	U8_CARRY | U8_TOO_LARGE | U8_TOO_LARGE_1000 | U8_SURROGATE,
+	U8_CARRY | U8_TOO_LARGE | U8_TOO_LARGE_1000,
+	U8_CARRY | U8_TOO_LARGE | U8_TOO_LARGE_1000,
+};
+
+static const uint8_t utf8_byte_2_high[16] = {
+	U8_TOO_SHORT, U8_TOO_SHORT, U8_TOO_SHORT, U8_TOO_SHORT,
+	U8_TOO_SHORT, U8_TOO_SHORT, U8_TOO_SHORT, U8_TOO_SHORT,
+	U8_TOO_LONG | U8_OVERLONG_2 | U8_TWO_CONTS | U8_OVERLONG_3 |
+		U8_TOO_LARGE_1000 | U8_OVERLONG_4,
+	U8_TOO_LONG | U8_OVERLONG_2 | U8_TWO_CONTS | U8_OVERLONG_3 |
+		U8_TOO_LARGE,
+	U8_TOO_LONG | U8_OVERLONG_2 | U8_TWO_CONTS | U8_SURROGATE |
+		U8_TOO_LARGE,
+	U8_TOO_LONG | U8_OVERLONG_2 | U8_TWO_CONTS | U8_SURROGATE |
+		U8_TOO_LARGE,
+	U8_TOO_SHORT, U8_TOO_SHORT, U8_TOO_SHORT, U8_TOO_SHORT,
+};
+
+/* bytes that must not appear in the last three positions of a block */
+static const uint8_t utf8_max_value[32] = {
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xef, 0xdf, 0xbf,
+};
+
+__attribute__((target("avx2")))
+static inline __m256i avx2_table(const uint8_t *table)
 {
-	return str_resize(self, 0);
+	return _mm256_broadcastsi128_si256(
+		_mm_loadu_si128((const __m128i *)table));
 }
 
-vec_str_t str_split(const str_t self, const char *sep)
+__attribute__((target("avx2")))
+static inline __m256i avx2_high_nibble(const __m256i in)
+{
+	return _mm256_and_si256(_mm256_srli_epi16(in, 4),
+				_mm256_set1_epi8(0x0f));
+}
+
+__attribute__((target("avx2")))
+static bool utf8_valid_avx2(const uint8_t *s, const size_t len)
+{
+	const __m256i byte_1_high = avx2_table(utf8_byte_1_high);
+	const __m256i byte_1_low = avx2_table(utf8_byte_1_low);
+	const __m256i byte_2_high = avx2_table(utf8_byte_2_high);
+	const __m256i max_value = _mm256_loadu_si256((const __m256i *)utf8_max_value);
+	const __m256i low_nibble = _mm256_set1_epi8(0x0f);
+	__m256i prev = _mm256_setzero_si256();
+	__m256i prev_incomplete = _mm256_setzero_si256();
+	__m256i error = _mm256_setzero_si256();
+	uint8_t tail[32];
+	size_t i = 0;
+
+	/* the last block is zero padded, so truncated sequences are reported */
+	while (i <= len) {
+		__m256i in;
+
+		if (len - i >= 32) {
+			in = _mm256_loadu_si256((const __m256i *)(s + i));
+		} else {
+			memset(tail, 0, sizeof(tail));
+			memcpy(tail, s + i, len - i);
+			in = _mm256_loadu_si256((const __m256i *)tail);
+		}
+
+		if (!_mm256_movemask_epi8(in)) {
+			error = _mm256_or_si256(error, prev_incomplete);
+			prev_incomplete = _mm256_setzero_si256();
+		} else {
+			__m256i shift = _mm256_permute2x128_si256(prev, in, 0x21);
+			__m256i prev1 = _mm256_alignr_epi8(in, shift, 15);
+			__m256i prev2 = _mm256_alignr_epi8(in, shift, 14);
+			__m256i prev3 = _mm256_alignr_epi8(in, shift, 13);
+			__m256i sc;
+			__m256i must23;
+
+			sc = _mm256_and_si256(
+				_mm256_and_si256(
+					_mm256_shuffle_epi8(byte_1_high,
+						avx2_high_nibble(prev1)),
+					_mm256_shuffle_epi8(byte_1_low,
+						_mm256_and_si256(prev1, low_nibble))),
+				_mm256_shuffle_epi8(byte_2_high,
+					avx2_high_nibble(in)));
+
+			must23 = _mm256_or_si256(
+				_mm256_subs_epu8(prev2, _mm256_set1_epi8(0x60)),
+				_mm256_subs_epu8(prev3, _mm256_set1_epi8(0x70)));
+			must23 = _mm256_and_si256(must23,
+				_mm256_set1_epi8((char)0x80));
+
+			error = _mm256_or_si256(error, _mm256_xor_si256(must23, sc));
+			prev_incomplete = _mm256_subs_epu8(in, max_value);
+		}
+
+		prev = in;
+		i += 32;
+	}
+
+	return _mm256_testz_si256(error, error);
+}
+
+__attribute__((target("avx2,popcnt")))
+static size_t utf8_length_avx2(const uint8_t *s, const size_t len)
+{
+	const __m256i cont = _mm256_set1_epi8(-65);
+	size_t count = 0;
+	size_t i = 0;
+
+	/* continuation bytes are the only ones <= -65 when read as signed */
+	for (; i + 32 <= len; i += 32) {
+		__m256i in = _mm256_loadu_si256((const __m256i *)(s + i));
+		unsigned int mask = (unsigned int)_mm256_movemask_epi8(
+			_mm256_cmpgt_epi8(in, cont));
+
+		count += (size_t)__builtin_popcount(mask);
+	}
+
+	return count + utf8_length_scalar(s + i, len - i);
+}
+#endif
+
+bool str_utf8_valid(const str_t self)
 {
 	assert(self);
-	assert(sep);
 
-	str_t copy;
-	vec_str_t vec_str;
-	char *token;
+	vec_obj_t *obj = vec_object(self);
+	size_t flags = vec_cache_get(obj);
+	bool valid;
 
-	copy = str_new(self);
-	if (!copy)
-		return NULL;
+	if (flags & VEC_CACHE_UTF8_CHECKED)
+		return flags & VEC_CACHE_UTF8_VALID;
 
-	vec_str = vec_new(sizeof(str_t));
-	if (!vec_str)
-		goto error;
+#ifdef HAVE_AVX2
+	if (__builtin_cpu_supports("avx2"))
+		valid = utf8_valid_avx2((const uint8_t *)self, obj->count);
+	else
+#endif
+		valid = utf8_valid_scalar((const uint8_t *)self, obj->count);
 
-	token = strtok(copy, sep);
-	while (token) {
-		vec_str_t v_tmp = vec_extend(vec_str, 1);
-		if (!v_tmp)
-			goto error;
+	vec_cache_set(obj, VEC_CACHE_UTF8_CHECKED |
+		      (valid ? VEC_CACHE_UTF8_VALID : 0));
 
-		vec_str = v_tmp;
+	return valid;
+}
 
-		str_t s_tmp = str_new(token);
-		if (!s_tmp)
-			goto error;
+size_t str_utf8_length(const str_t self)
+{
+	assert(self);
 
-		vec_str[vec_count(vec_str) - 1] = s_tmp;
-		token = strtok(NULL, sep);
+#ifdef HAVE_AVX2
+	if (__builtin_cpu_supports("avx2"))
+		return utf8_length_avx2((const uint8_t *)self, str_length(self));
+#endif
+
+	return utf8_length_scalar((const uint8_t *)self, str_length(self));
+}
+
+/* decode one code point from valid UTF-8, returning the number of bytes */
+static inline size_t utf8_decode(const uint8_t *s, uint32_t *cp)
+{
+	if (s[0] < 0x80) {
+		*cp = s[0];
+		return 1;
 	}
 
-	str_free(copy);
+	if (s[0] < 0xe0) {
+		*cp = ((uint32_t)(s[0] & 0x1f) << 6) | (s[1] & 0x3f);
+		return 2;
+	}
 
-	return vec_str;
+	if (s[0] < 0xf0) {
+		*cp = ((uint32_t)(s[0] & 0x0f) << 12) |
+			((uint32_t)(s[1] & 0x3f) << 6) | (s[2] & 0x3f);
+		return 3;
+	}
 
-error:
-	if (copy)
-		str_free(copy);
-	if (vec_str)
-		str_list_free(vec_str);
+	*cp = ((uint32_t)(s[0] & 0x07) << 18) | ((uint32_t)(s[1] & 0x3f) << 12) |
+		((uint32_t)(s[2] & 0x3f) << 6) | (s[3] & 0x3f);
+	return 4;
+}
 
-	return NULL;
+/* encode a valid code point, returning the number of bytes */
+static inline size_t utf8_encode(const uint32_t cp, uint8_t *s)
+{
+	if (cp < 0x80) {
+		s[0] = (uint8_t)cp;
+		return 1;
+	}
+
+	if (cp < 0x800) {
+		s[0] = (uint8_t)(0xc0 | (cp >> 6));
+		s[1] = (uint8_t)(0x80 | (cp & 0x3f));
+		return 2;
+	}
+
+	if (cp < 0x10000) {
+		s[0] = (uint8_t)(0xe0 | (cp >> 12));
+		s[1] = (uint8_t)(0x80 | ((cp >> 6) & 0x3f));
+		s[2] = (uint8_t)(0x80 | (cp & 0x3f));
+		return 3;
+	}
+
+	s[0] = (uint8_t)(0xf0 | (cp >> 18));
+	s[1] = (uint8_t)(0x80 | ((cp >> 12) & 0x3f));
+	s[2] = (uint8_t)(0x80 | ((cp >> 6) & 0x3f));
+	s[3] = (uint8_t)(0x80 | (cp & 0x3f));
+	return 4;
 }
 
-void str_list_free(vec_str_t list)
+static inline size_t utf16_put(const uint32_t cp, uint16_t *out)
 {
-	assert(list);
+	if (cp < 0x10000) {
+		out[0] = (uint16_t)cp;
+		return 1;
+	}
 
-	for (size_t i = 0; i < vec_count(list); i++)
-		str_free(list[i]);
+	out[0] = (uint16_t)(0xd800 | ((cp - 0x10000) >> 10));
+	out[1] = (uint16_t)(0xdc00 | ((cp - 0x10000) & 0x3ff));
+	return 2;
+}
 
-	vec_free(list);
+/* read one code point from UTF-16, returning 0 on unpaired surrogates */
+static inline size_t utf16_get(const uint16_t *in, const size_t len,
+			       uint32_t *cp)
+{
+	if (in[0] < 0xd800 || in[0] > 0xdfff) {
+		*cp = in[0];
+		return 1;
+	}
+
+	if (in[0] > 0xdbff || len < 2 || in[1] < 0xdc00 || in[1] > 0xdfff)
+		return 0;
+
+	*cp = 0x10000 + ((uint32_t)(in[0] - 0xd800) << 10) +
+		(uint32_t)(in[1] - 0xdc00);
+	return 2;
 }
 
-bool str_startswith(const str_t self, const char *sub)
+static size_t utf8_to_utf16_scalar(const uint8_t *s, const size_t len,
+				   uint16_t *out)
+{
+	size_t i = 0;
+	size_t n = 0;
+	uint32_t cp;
+
+	while (i < len) {
+		i += utf8_decode(s + i, &cp);
+		n += utf16_put(cp, out + n);
+	}
+
+	return n;
+}
+
+static size_t utf8_to_utf32_scalar(const uint8_t *s, const size_t len,
+				   uint32_t *out)
+{
+	size_t i = 0;
+	size_t n = 0;
+
+	while (i < len)
+		i += utf8_decode(s + i, out + n++);
+
+	return n;
+}
+
+static size_t utf16_to_utf8_scalar(const uint16_t *in, const size_t len,
+				   uint8_t *out)
+{
+	size_t i = 0;
+	size_t n = 0;
+	uint32_t cp = 0;
+
+	while (i < len) {
+		i += utf16_get(in + i, len - i, &cp);
+		n += utf8_encode(cp, out + n);
+	}
+
+	return n;
+}
+
+static size_t utf32_to_utf8_scalar(const uint32_t *in, const size_t len,
+				   uint8_t *out)
+{
+	size_t n = 0;
+
+	for (size_t i = 0; i < len; i++)
+		n += utf8_encode(in[i], out + n);
+
+	return n;
+}
+
+#ifdef HAVE_AVX2
+/*
+ * The AVX2 transcoders widen or narrow whole blocks of ASCII characters at
+ * once and fall back to the scalar code for a single code point otherwise.
+ */
+__attribute__((target("avx2")))
+static size_t utf8_to_utf16_avx2(const uint8_t *s, const size_t len,
+				 uint16_t *out)
+{
+	size_t i = 0;
+	size_t n = 0;
+	uint32_t cp;
+
+	while (i < len) {
+		if (len - i >= 16) {
+			__m128i in = _mm_loadu_si128((const __m128i *)(s + i));
+
+			if (!_mm_movemask_epi8(in)) {
+				_mm256_storeu_si256((__m256i *)(out + n),
+						    _mm256_cvtepu8_epi16(in));
+				i += 16;
+				n += 16;
+				continue;
+			}
+		}
+
+		i += utf8_decode(s + i, &cp);
+		n += utf16_put(cp, out + n);
+	}
+
+	return n;
+}
+
+__attribute__((target("avx2")))
+static size_t utf8_to_utf32_avx2(const uint8_t *s, const size_t len,
+				 uint32_t *out)
+{
+	size_t i = 0;
+	size_t n = 0;
+
+	while (i < len) {
+		if (len - i >= 16) {
+			__m128i in = _mm_loadu_si128((const __m128i *)(s + i));
+
+			if (!_mm_movemask_epi8(in)) {
+				_mm256_storeu_si256((__m256i *)(out + n),
+						    _mm256_cvtepu8_epi32(in));
+				_mm256_storeu_si256((__m256i *)(out + n + 8),
+						    _mm256_cvtepu8_epi32(
+							_mm_srli_si128(in, 8)));
+				i += 16;
+				n += 16;
+				continue;
+			}
+		}
+
+		i += utf8_decode(s + i, out + n++);
+	}
+
+	return n;
+}
+
+__attribute__((target("avx2")))
+static size_t utf16_to_utf8_avx2(const uint16_t *in, const size_t len,
+				 uint8_t *out)
+{
+	const __m256i mask = _mm256_set1_epi16((short)0xff80);
+	size_t i = 0;
+	size_t n = 0;
+	uint32_t cp = 0;
+
+	while (i < len) {
+		if (len - i >= 16) {
+			__m256i v = _mm256_loadu_si256((const __m256i *)(in + i));
+
+			if (_mm256_testz_si256(v, mask)) {
+				_mm_storeu_si128((__m128i *)(out + n),
+					_mm_packus_epi16(
+						_mm256_castsi256_si128(v),
+						_mm256_extracti128_si256(v, 1)));
+				i += 16;
+				n += 16;
+				continue;
+			}
+		}
+
+		i += utf16_get(in + i, len - i, &cp);
+		n += utf8_encode(cp, out + n);
+	}
+
+	return n;
+}
+
+__attribute__((target("avx2")))
+static size_t utf32_to_utf8_avx2(const uint32_t *in, const size_t len,
+				 uint8_t *out)
+{
+	const __m256i mask = _mm256_set1_epi32((int)0xffffff80);
+	size_t i = 0;
+	size_t n = 0;
+
+	while (i < len) {
+		if (len - i >= 8) {
+			__m256i v = _mm256_loadu_si256((const __m256i *)(in + i));
+
+			if (_mm256_testz_si256(v, mask)) {
+				__m128i w = _mm_packus_epi32(
+					_mm256_castsi256_si128(v),
+					_mm256_extracti128_si256(v, 1));
+
+				_mm_storel_epi64((__m128i *)(out + n),
+						 _mm_packus_epi16(w, w));
+				i += 8;
+				n += 8;
+				continue;
+			}
+		}
+
+		n += utf8_encode(in[i++], out + n);
+	}
+
+	return n;
+}
+#endif
+
+vec_utf16_t str_to_utf16(const str_t self)
 {
 	assert(self);
-	assert(sub);
 
-	size_t str_len;
-	size_t sub_len;
+	size_t len = str_length(self);
+	vec_utf16_t out;
+	size_t n;
 
-	str_len = str_length(self);
-	sub_len = strlen(sub);
+	if (!str_utf8_valid(self))
+		return NULL;
 
-	if (sub_len > str_len)
-		return false;
+	/* every code unit takes at least one byte */
+	out = vec_new_len(sizeof(uint16_t), len);
+	if (!out)
+		return NULL;
 
-	if (strncmp(self, sub, sub_len))
-		return false;
+#ifdef HAVE_AVX2
+	if (__builtin_cpu_supports("avx2"))
+		n = utf8_to_utf16_avx2((const uint8_t *)self, len, out);
+	else
+#endif
+		n = utf8_to_utf16_scalar((const uint8_t *)self, len, out);
+
+	/* shrinking never triggers realloc */
+	return vec_resize(out, n);
+}
+
+vec_utf32_t str_to_utf32(const str_t self)
+{
+	assert(self);
+
+	size_t len = str_length(self);
+	vec_utf32_t out;
+	size_t n;
+
+	if (!str_utf8_valid(self))
+		return NULL;
+
+	/* every code point takes at least one byte */
+	out = vec_new_len(sizeof(uint32_t), len);
+	if (!out)
+		return NULL;
+
+#ifdef HAVE_AVX2
+	if (__builtin_cpu_supports("avx2"))
+		n = utf8_to_utf32_avx2((const uint8_t *)self, len, out);
+	else
+#endif
+		n = utf8_to_utf32_scalar((const uint8_t *)self, len, out);
+
+	return vec_resize(out, n);
+}
+
+str_t str_from_utf16(const vec_utf16_t vec)
+{
+	assert(vec);
+
+	size_t len = vec_count(vec);
+	size_t bytes = 0;
+	size_t i = 0;
+	uint32_t cp;
+	str_t self;
+
+	/* validate and compute the exact length, so we allocate only once */
+	while (i < len) {
+		size_t units = utf16_get(vec + i, len - i, &cp);
+
+		if (!units)
+			return NULL;
+
+		bytes += cp < 0x80 ? 1 : cp < 0x800 ? 2 : cp < 0x10000 ? 3 : 4;
+		i += units;
+	}
+
+	self = str_new_len(bytes);
+	if (!self)
+		return NULL;
+
+#ifdef HAVE_AVX2
+	if (__builtin_cpu_supports("avx2"))
+		utf16_to_utf8_avx2(vec, len, (uint8_t *)self);
+	else
+#endif
+		utf16_to_utf8_scalar(vec, len, (uint8_t *)self);
+
+	return self;
+}
+
+str_t str_from_utf32(const vec_utf32_t vec)
+{
+	assert(vec);
+
+	size_t len = vec_count(vec);
+	size_t bytes = 0;
+	str_t self;
+
+	for (size_t i = 0; i < len; i++) {
+		uint32_t cp = vec[i];
+
+		if (cp > 0x10ffff || (cp >= 0xd800 && cp <= 0xdfff))
+			return NULL;
+
+		bytes += cp < 0x80 ? 1 : cp < 0x800 ? 2 : cp < 0x10000 ? 3 : 4;
+	}
+
+	self = str_new_len(bytes);
+	if (!self)
+		return NULL;
+
+#ifdef HAVE_AVX2
+	if (__builtin_cpu_supports("avx2"))
+		utf32_to_utf8_avx2(vec, len, (uint8_t *)self);
+	else
+#endif
+		utf32_to_utf8_scalar(vec, len, (uint8_t *)self);
+
+	return self;
+}
+
+/*
+ * The string hash is derived from wyhash: the input is consumed 48 bytes at a
+ * time by three independent multiply-mix lanes, which keeps several
+ * multipliers busy on long strings.
+ */
+static const uint64_t hash_secret[4] = {
+	0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL,
+	0x4b33a62ed433d4a3ULL, 0x4d5a2da51de1aa47ULL,
+};
+
+static inline void hash_mum(uint64_t *a, uint64_t *b)
+{
+#ifdef __SIZEOF_INT128__
+	__extension__ unsigned __int128 r = *a;
+
+	r *= *b;
+	*a = (uint64_t)r;
+	*b = (uint64_t)(r >> 64);
+#else
+	uint64_t ha = *a >> 32, hb = *b >> 32;
+	uint64_t la = (uint32_t)*a, lb = (uint32_t)*b;
+	uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+	uint64_t t = rl + (rm0 << 32);
+	uint64_t c = t < rl;
+	uint64_t lo = t + (rm1 << 32);
+
+	c += lo < t;
+	*a = lo;
+	*b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+static inline uint64_t hash_mix(uint64_t a, uint64_t b)
+{
+	hash_mum(&a, &b);
+	return a ^ b;
+}
+
+static inline uint64_t hash_read8(const uint8_t *p)
+{
+	uint64_t v;
+
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static inline uint64_t hash_read4(const uint8_t *p)
+{
+	uint32_t v;
+
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static uint64_t hash_bytes(const uint8_t *p, const size_t len)
+{
+	const uint64_t *s = hash_secret;
+	uint64_t seed = hash_mix(s[0], s[1]);
+	uint64_t a;
+	uint64_t b;
+
+	if (len <= 16) {
+		if (len >= 4) {
+			size_t off = (len >> 3) << 2;
+
+			a = (hash_read4(p) << 32) | hash_read4(p + off);
+			b = (hash_read4(p + len - 4) << 32) |
+				hash_read4(p + len - 4 - off);
+		} else if (len > 0) {
+			a = ((uint64_t)p[0] << 16) | ((uint64_t)p[len >> 1] << 8) |
+				p[len - 1];
+			b = 0;
+		} else {
+			a = b = 0;
+		}
+	} else {
+		size_t i = len;
+
+		if (i >= 48) {
+			uint64_t see1 = seed;
+			uint64_t see2 = seed;
+
+			do {
+				seed = hash_mix(hash_read8(p) ^ s[1],
+						hash_read8(p + 8) ^ seed);
+				see1 = hash_mix(hash_read8(p + 16) ^ s[2],
+						hash_read8(p + 24) ^ see1);
+				see2 = hash_mix(hash_read8(p + 32) ^ s[3],
+						hash_read8(p + 40) ^ see2);
+				p += 48;
+				i -= 48;
+			} while (i >= 48);
+
+			seed ^= see1 ^ see2;
+		}
+
+		while (i > 16) {
+			seed = hash_mix(hash_read8(p) ^ s[1],
+					hash_read8(p + 8) ^ seed);
+			i -= 16;
+			p += 16;
+		}
+
+		a = hash_read8(p + i - 16);
+		b = hash_read8(p + i - 8);
+	}
+
+	a ^= s[1];
+	b ^= seed;
+	hash_mum(&a, &b);
+
+	return hash_mix(a ^ s[0] ^ len, b ^ s[1]);
+}
+
+uint64_t str_hash(const str_t self)
+{
+	assert(self);
+
+	vec_obj_t *obj = vec_object(self);
+	uint64_t hash;
+
+	if (vec_cache_get(obj) & VEC_CACHE_HASH)
+		return __atomic_load_n(&str_meta(obj)->hash, __ATOMIC_RELAXED);
+
+	hash = hash_bytes((const uint8_t *)self, obj->count);
+
+	__atomic_store_n(&str_meta(obj)->hash, hash, __ATOMIC_RELAXED);
+	vec_cache_set(obj, VEC_CACHE_HASH);
+
+	return hash;
+}
+
+str_t str_insert(str_t self, const size_t pos, const char *str)
+{
+	assert(self);
+	assert(str);
+
+	size_t old_len = str_length(self);
+
+	if (pos > old_len)
+		return NULL;
+
+	size_t str_len = strlen(str);
+
+	self = str_extend(self, str_len);
+	if (!self)
+		return NULL;
+
+	vec_copy(self, pos + str_len, vec_ptr_at(self, pos), old_len - pos);
+	vec_copy(self, pos, str, str_len);
+
+	return self;
+}
+
+str_t str_append(str_t self, const char *str)
+{
+	return str_insert(self, str_length(self), str);
+}
+
+str_t str_concat(str_t self, ...)
+{
+	assert(self);
+
+	size_t len = str_length(self);
+	size_t total = len;
+	const char *s;
+	va_list ap;
+	va_list aq;
+
+	va_start(ap, self);
+	va_copy(aq, ap);
+
+	while ((s = va_arg(ap, const char *))) {
+		size_t n = strlen(s);
+
+		if (total > SIZE_MAX - n) {
+			self = NULL;
+			goto exit;
+		}
+
+		total += n;
+	}
+
+	self = str_resize(self, total);
+	if (!self)
+		goto exit;
+
+	while ((s = va_arg(aq, const char *))) {
+		size_t n = strlen(s);
+
+		memcpy(self + len, s, n);
+		len += n;
+	}
+
+exit:
+	va_end(aq);
+	va_end(ap);
+
+	return self;
+}
+
+str_t str_writev(str_t self, const str_iovec_t *pieces, const size_t count)
+{
+	assert(self);
+	assert(pieces || !count);
+
+	size_t len = str_length(self);
+	size_t total = len;
+
+	for (size_t i = 0; i < count; i++) {
+		if (total > SIZE_MAX - pieces[i].len)
+			return NULL;
+
+		total += pieces[i].len;
+	}
+
+	self = str_resize(self, total);
+	if (!self)
+		return NULL;
+
+	for (size_t i = 0; i < count; i++) {
+		memcpy(self + len, pieces[i].ptr, pieces[i].len);
+		len += pieces[i].len;
+	}
+
+	return self;
+}
+
+str_t str_join(const vec_str_t list, const char *sep)
+{
+	assert(list);
+	assert(sep);
+
+	size_t count = vec_count(list);
+	size_t sep_len = strlen(sep);
+	size_t total = 0;
+	size_t pos = 0;
+	str_t self;
+
+	for (size_t i = 0; i < count; i++) {
+		size_t n = str_length(list[i]) + (i ? sep_len : 0);
+
+		if (total > SIZE_MAX - n)
+			return NULL;
+
+		total += n;
+	}
+
+	self = str_new_len(total);
+	if (!self)
+		return NULL;
+
+	for (size_t i = 0; i < count; i++) {
+		if (i) {
+			memcpy(self + pos, sep, sep_len);
+			pos += sep_len;
+		}
+
+		memcpy(self + pos, list[i], str_length(list[i]));
+		pos += str_length(list[i]);
+	}
+
+	return self;
+}
+
+str_t str_clear(str_t self)
+{
+	return str_resize(self, 0);
+}
+
+/*
+ * A set of bytes stored as a 256-bit table: byte `c` is a member when bit
+ * `(c >> 4) & 7` of row `c & 0x0f` is set, using `lo` rows for ASCII and `hi`
+ * rows for the other bytes. This layout lets SIMD code test 32 bytes at once
+ * with two nibble lookups.
+ */
+typedef struct
+{
+	uint8_t lo[16];
+	uint8_t hi[16];
+} charset_t;
+
+#define WHITESPACE " \t\n\v\f\r"
+
+static void charset_init(charset_t *set, const char *chars)
+{
+	memset(set, 0, sizeof(*set));
+
+	for (const uint8_t *c = (const uint8_t *)chars; *c; c++) {
+		uint8_t *row = (*c & 0x80) ? set->hi : set->lo;
+		row[*c & 0x0f] |= (uint8_t)(1U << ((*c >> 4) & 7));
+	}
+}
+
+static inline bool charset_has(const charset_t *set, const uint8_t c)
+{
+	const uint8_t *row = (c & 0x80) ? set->hi : set->lo;
+	return row[c & 0x0f] & (1U << ((c >> 4) & 7));
+}
+
+#ifdef HAVE_AVX2
+static const uint8_t charset_bits[16] = {
+	0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80,
+	0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80,
+};
+
+__attribute__((target("avx2")))
+static size_t charset_scan_avx2(const charset_t *set, const uint8_t *s,
+				const size_t len, const bool member)
+{
+	const __m256i lo = avx2_table(set->lo);
+	const __m256i hi = avx2_table(set->hi);
+	const __m256i bits = avx2_table(charset_bits);
+	const __m256i nibble = _mm256_set1_epi8(0x0f);
+	size_t i = 0;
+
+	for (; i + 32 <= len; i += 32) {
+		__m256i in = _mm256_loadu_si256((const __m256i *)(s + i));
+		__m256i low = _mm256_and_si256(in, nibble);
+		__m256i row = _mm256_blendv_epi8(_mm256_shuffle_epi8(lo, low),
+						 _mm256_shuffle_epi8(hi, low), in);
+		__m256i bit = _mm256_shuffle_epi8(bits, avx2_high_nibble(in));
+		__m256i miss = _mm256_cmpeq_epi8(_mm256_and_si256(row, bit),
+						 _mm256_setzero_si256());
+		uint32_t mask = (uint32_t)_mm256_movemask_epi8(miss);
+
+		if (member ? mask : ~mask)
+			return i + (size_t)__builtin_ctz(member ? mask : ~mask);
+	}
+
+	return i;
+}
+#endif
+
+/* return the position of the first byte from `start` whose membership
+ * differs from `member`, or `len` if there's none */
+static size_t charset_scan(const charset_t *set, const char *str,
+			   const size_t start, const size_t len,
+			   const bool member)
+{
+	const uint8_t *s = (const uint8_t *)str;
+	size_t i = start;
+
+#ifdef HAVE_AVX2
+	if (__builtin_cpu_supports("avx2"))
+		i += charset_scan_avx2(set, s + start, len - start, member);
+#endif
+
+	while (i < len && charset_has(set, s[i]) == member)
+		i++;
+
+	return i;
+}
+
+size_t str_span(const str_t self, const char *charset)
+{
+	assert(self);
+	assert(charset);
+
+	charset_t set;
+
+	charset_init(&set, charset);
+
+	return charset_scan(&set, self, 0, str_length(self), true);
+}
+
+size_t str_cspan(const str_t self, const char *charset)
+{
+	assert(self);
+	assert(charset);
+
+	charset_t set;
+
+	charset_init(&set, charset);
+
+	return charset_scan(&set, self, 0, str_length(self), false);
+}
+
+str_t str_ltrim(str_t self)
+{
+	assert(self);
+
+	size_t len = str_length(self);
+	size_t start = str_span(self, WHITESPACE);
+
+	if (!start)
+		return self;
+
+	self = str_detach(self, len);
+	if (!self)
+		return NULL;
+
+	memmove(self, self + start, len - start);
+
+	return str_resize(self, len - start);
+}
+
+str_t str_rtrim(str_t self)
+{
+	assert(self);
+
+	charset_t set;
+	size_t len = str_length(self);
+
+	charset_init(&set, WHITESPACE);
+
+	while (len && charset_has(&set, (uint8_t)self[len - 1]))
+		len--;
+
+	if (len == str_length(self))
+		return self;
+
+	return str_resize(self, len);
+}
+
+str_t str_trim(str_t self)
+{
+	self = str_rtrim(self);
+	if (!self)
+		return NULL;
+
+	return str_ltrim(self);
+}
+
+vec_str_t str_split(const str_t self, const char *sep)
+{
+	assert(self);
+	assert(sep);
+
+	charset_t set;
+	vec_str_t vec_str;
+	size_t len = str_length(self);
+	size_t start;
+	size_t end = 0;
+
+	vec_str = vec_new(sizeof(str_t));
+	if (!vec_str)
+		return NULL;
+
+	charset_init(&set, sep);
+
+	while (true) {
+		start = charset_scan(&set, self, end, len, true);
+		if (start == len)
+			break;
+
+		end = charset_scan(&set, self, start, len, false);
+
+		str_t s_tmp = str_new_len(end - start);
+		if (!s_tmp)
+			goto error;
+
+		memcpy(s_tmp, self + start, end - start);
+
+		vec_str_t v_tmp = vec_extend(vec_str, 1);
+		if (!v_tmp) {
+			str_free(s_tmp);
+			goto error;
+		}
+
+		vec_str = v_tmp;
+		vec_str[vec_count(vec_str) - 1] = s_tmp;
+	}
+
+	return vec_str;
+
+error:
+	str_list_free(vec_str);
+
+	return NULL;
+}
+
+void str_list_free(vec_str_t list)
+{
+	assert(list);
+
+	for (size_t i = 0; i < vec_count(list); i++)
+		str_free(list[i]);
+
+	vec_free(list);
+}
+
+bool str_startswith(const str_t self, const char *sub)
+{
+	assert(self);
+	assert(sub);
+
+	size_t str_len;
+	size_t sub_len;
+
+	str_len = str_length(self);
+	sub_len = strlen(sub);
+
+	if (sub_len > str_len)
+		return false;
+
+	if (strncmp(self, sub, sub_len))
+		return false;
+
+	return true;
+}
+
+bool str_endswith(const str_t self, const char *sub)
+{
+	assert(self);
+	assert(sub);
+
+	size_t str_len;
+	size_t sub_len;
+
+	str_len = str_length(self);
+	sub_len = strlen(sub);
+
+	if (sub_len > str_len)
+		return false;
+
+	if (strncmp(self + str_len - sub_len, sub, sub_len))
+		return false;
+
+	return true;
+}
+
+static inline char ascii_lower(const char c)
+{
+	return (c >= 'A' && c <= 'Z') ? (char)(c + 'a' - 'A') : c;
+}
+
+static inline bool chr_equal(const char a, const char b, const bool icase)
+{
+	if (icase)
+		return ascii_lower(a) == ascii_lower(b);
+
+	return a == b;
+}
+
+static bool mem_equal_icase(const char *a, const char *b, const size_t len)
+{
+	for (size_t i = 0; i < len; i++) {
+		if (ascii_lower(a[i]) != ascii_lower(b[i]))
+			return false;
+	}
+
+	return true;
+}
+
+static void kmp_compute_lps(const char *pat, const size_t pat_len, size_t *lps,
+			    const bool icase)
+{
+	assert(pat);
+	assert(lps);
+
+	size_t i = 1;
+	size_t len = 0;
+
+	lps[0] = 0;
+
+	while (i < pat_len) {
+		if (chr_equal(pat[i], pat[len], icase)) {
+			len++;
+			vec_set(lps, i, &len);
+			i++;
+		} else {
+			if (len != 0) {
+				vec_get(lps, len - 1, &len);
+			} else {
+				vec_set(lps, i, &(size_t){0});
+				i++;
+			}
+		}
+	}
+}
+
+/* append to `pos` the matches inside `s`, shifted by `base` */
+static bool kmp_search(vec_index_t *pos, const char *s, const size_t n,
+		       const char *pat, const size_t m, const size_t *lps,
+		       const bool icase, const size_t base)
+{
+	size_t i = 0;
+	size_t j = 0;
+
+	while (i < n) {
+		if (chr_equal(s[i], pat[j], icase)) {
+			i++;
+			j++;
+		}
+
+		if (j == m) {
+			vec_index_t next = vec_push(*pos, &(size_t){base + i - j});
+			if (!next)
+				return false;
+
+			*pos = next;
+			j = lps[j - 1];
+		} else if (i < n && !chr_equal(s[i], pat[j], icase)) {
+			if (j != 0)
+				j = lps[j - 1];
+			else
+				i++;
+		}
+	}
+
+	return true;
+}
+
+static vec_index_t kmp_find(const str_t self, const char *pat,
+			    const bool icase)
+{
+	assert(self);
+	assert(pat);
+
+	size_t m = strlen(pat);
+	size_t *lps = NULL;
+	vec_index_t pos = NULL;
+
+	if (!m)
+		return NULL;
+
+	pos = vec_new(sizeof(size_t));
+	if (!pos)
+		goto exit;
+
+	lps = vec_new_len(sizeof(size_t), m);
+	if (!lps) {
+		vec_free(pos);
+		pos = NULL;
+		goto exit;
+	}
+
+	kmp_compute_lps(pat, m, lps, icase);
+
+	if (!kmp_search(&pos, self, str_length(self), pat, m, lps, icase, 0)) {
+		vec_free(pos);
+		pos = NULL;
+	}
+
+exit:
+	if (lps)
+		vec_free(lps);
+
+	return pos;
+}
+
+vec_index_t str_find(const str_t self, const char *pat)
+{
+	return kmp_find(self, pat, false);
+}
+
+vec_index_t str_find_icase(const str_t self, const char *pat)
+{
+	return kmp_find(self, pat, true);
+}
+
+typedef struct
+{
+	size_t start;
+	size_t end;		/* matches must start before this */
+	vec_index_t found;
+} find_chunk_t;
+
+typedef struct
+{
+	str_t str;
+	const char *pat;
+	size_t pat_len;
+	const size_t *lps;
+} find_ctx_t;
+
+static void find_chunks(void *items, const size_t start, const size_t len,
+			void *ctx)
+{
+	find_chunk_t *chunks = items;
+	const find_ctx_t *find = ctx;
+	size_t str_len = str_length(find->str);
+
+	(void)start;
+
+	for (size_t i = 0; i < len; i++) {
+		find_chunk_t *chunk = &chunks[i];
+		size_t end = chunk->end + find->pat_len - 1;
+
+		if (end > str_len)
+			end = str_len;
+
+		chunk->found = vec_new(sizeof(size_t));
+		if (!chunk->found)
+			continue;
+
+		if (!kmp_search(&chunk->found, find->str + chunk->start,
+				end - chunk->start, find->pat, find->pat_len,
+				find->lps, false, chunk->start)) {
+			vec_free(chunk->found);
+			chunk->found = NULL;
+		}
+	}
+}
+
+vec_index_t str_find_parallel(const str_t self, const char *pat,
+			      size_t nthreads)
+{
+	assert(self);
+	assert(pat);
+
+	size_t str_len = str_length(self);
+	size_t pat_len = strlen(pat);
+	vec_pool_t pool = vec_pool_default();
+	find_chunk_t *chunks = NULL;
+	size_t *lps = NULL;
+	vec_index_t pos = NULL;
+	size_t total = 0;
+	find_ctx_t ctx = {
+		.str = self,
+		.pat = pat,
+		.pat_len = pat_len,
+	};
+
+	if (!nthreads)
+		nthreads = pool ? vec_pool_threads(pool) : 1;
+
+	if (nthreads > str_len / FIND_CHUNK_MIN)
+		nthreads = str_len / FIND_CHUNK_MIN;
+
+	if (!pat_len || nthreads <= 1)
+		return str_find(self, pat);
+
+	lps = vec_new_len(sizeof(size_t), pat_len);
+	chunks = vec_new_len(sizeof(find_chunk_t), nthreads);
+	if (!lps || !chunks)
+		goto exit;
+
+	kmp_compute_lps(pat, pat_len, lps, false);
+
+	for (size_t i = 0; i < nthreads; i++) {
+		chunks[i].start = str_len / nthreads * i;
+		chunks[i].end = i + 1 < nthreads ?
+			str_len / nthreads * (i + 1) : str_len;
+	}
+
+	ctx.lps = lps;
+	vec_pool_for(pool, chunks, find_chunks, &ctx, 1);
+
+	/* chunks are ordered, so concatenating their matches keeps the order */
+	for (size_t i = 0; i < nthreads; i++) {
+		if (!chunks[i].found)
+			goto exit;
+
+		total += vec_count(chunks[i].found);
+	}
+
+	pos = vec_new_len(sizeof(size_t), total);
+	if (!pos)
+		goto exit;
+
+	total = 0;
+
+	for (size_t i = 0; i < nthreads; i++) {
+		vec_copy(pos, total, chunks[i].found, vec_count(chunks[i].found));
+		total += vec_count(chunks[i].found);
+	}
+
+exit:
+	if (chunks) {
+		for (size_t i = 0; i < nthreads; i++) {
+			if (chunks[i].found)
+				vec_free(chunks[i].found);
+		}
+
+		vec_free(chunks);
+	}
+
+	if (lps)
+		vec_free(lps);
+
+	return pos;
+}
+
+bool str_startswith_icase(const str_t self, const char *sub)
+{
+	assert(self);
+	assert(sub);
+
+	size_t sub_len = strlen(sub);
+
+	if (sub_len > str_length(self))
+		return false;
+
+	return mem_equal_icase(self, sub, sub_len);
+}
+
+bool str_endswith_icase(const str_t self, const char *sub)
+{
+	assert(self);
+	assert(sub);
+
+	size_t str_len = str_length(self);
+	size_t sub_len = strlen(sub);
+
+	if (sub_len > str_len)
+		return false;
+
+	return mem_equal_icase(self + str_len - sub_len, sub, sub_len);
+}
+
+#ifdef HAVE_AVX2
+__attribute__((target("avx2")))
+static size_t ascii_case_avx2(char *s, const size_t len, const char first,
+			      const char last)
+{
+	const __m256i lo = _mm256_set1_epi8((char)(first - 1));
+	const __m256i hi = _mm256_set1_epi8((char)(last + 1));
+	const __m256i flip = _mm256_set1_epi8(0x20);
+	size_t i = 0;
+
+	/* bytes above 0x7f are negative, so they never fall in the range */
+	for (; i + 32 <= len; i += 32) {
+		__m256i in = _mm256_loadu_si256((const __m256i *)(s + i));
+		__m256i mask = _mm256_and_si256(_mm256_cmpgt_epi8(in, lo),
+						_mm256_cmpgt_epi8(hi, in));
+
+		_mm256_storeu_si256((__m256i *)(s + i),
+			_mm256_xor_si256(in, _mm256_and_si256(mask, flip)));
+	}
+
+	return i;
+}
+#endif
+
+/* flip the case of all the characters in [first, last] range */
+static str_t ascii_case(str_t self, const char first, const char last)
+{
+	assert(self);
+
+	size_t len = str_length(self);
+	size_t i = 0;
+
+	self = str_detach(self, len);
+	if (!self)
+		return NULL;
+
+#ifdef HAVE_AVX2
+	if (__builtin_cpu_supports("avx2"))
+		i = ascii_case_avx2(self, len, first, last);
+#endif
+
+	for (; i < len; i++) {
+		if (self[i] >= first && self[i] <= last)
+			self[i] = (char)(self[i] ^ 0x20);
+	}
+
+	vec_cache_reset(vec_object(self));
+
+	return self;
+}
+
+str_t str_to_lower(str_t self)
+{
+	return ascii_case(self, 'A', 'Z');
+}
+
+str_t str_to_upper(str_t self)
+{
+	return ascii_case(self, 'a', 'z');
+}
+
+typedef struct
+{
+	size_t offset;
+	size_t delete_len;
+	size_t insert_len;
+	const char *insert;
+	size_t index;
+} edit_t;
+
+static int edit_compare(const void *a, const void *b)
+{
+	const edit_t *ea = a;
+	const edit_t *eb = b;
+
+	if (ea->offset != eb->offset)
+		return ea->offset < eb->offset ? -1 : 1;
 
-	return true;
+	/* keep the caller order for edits at the same offset */
+	if (ea->index != eb->index)
+		return ea->index < eb->index ? -1 : 1;
+
+	return 0;
 }
 
-bool str_endswith(const str_t self, const char *sub)
+str_t str_apply_edits(str_t self, const str_edit_t *edits, const size_t count)
 {
 	assert(self);
-	assert(sub);
+	assert(edits || !count);
 
-	size_t str_len;
-	size_t sub_len;
+	size_t len = str_length(self);
+	size_t total = len;
+	size_t src = 0;
+	size_t dst = 0;
+	bool sorted = true;
+	edit_t *sorted_edits;
+	str_t str = NULL;
 
-	str_len = str_length(self);
-	sub_len = strlen(sub);
+	if (!count)
+		return self;
 
-	if (sub_len > str_len)
-		return false;
+	sorted_edits = vec_new_len(sizeof(edit_t), count);
+	if (!sorted_edits)
+		return NULL;
 
-	if (strncmp(self + str_len - sub_len, sub, sub_len))
-		return false;
+	for (size_t i = 0; i < count; i++) {
+		sorted_edits[i].offset = edits[i].offset;
+		sorted_edits[i].delete_len = edits[i].delete_len;
+		sorted_edits[i].insert = edits[i].insert;
+		sorted_edits[i].insert_len = edits[i].insert ?
+			strlen(edits[i].insert) : 0;
+		sorted_edits[i].index = i;
 
-	return true;
-}
+		if (i && edits[i].offset < edits[i - 1].offset)
+			sorted = false;
+	}
 
-static void kmp_compute_lps(const char *pat, const size_t pat_len, size_t *lps)
-{
-	assert(pat);
-	assert(lps);
+	if (!sorted)
+		qsort(sorted_edits, count, sizeof(edit_t), edit_compare);
 
-	size_t i = 1;
-	size_t len = 0;
+	/* validate edits and compute the final length */
+	for (size_t i = 0; i < count; i++) {
+		edit_t *e = sorted_edits + i;
 
-	lps[0] = 0;
+		if (e->offset > len || e->delete_len > len - e->offset)
+			goto exit;
 
-	while (i < pat_len) {
-		if (pat[i] == pat[len]) {
-			len++;
-			vec_set(lps, i, &len);
-			i++;
-		} else {
-			if (len != 0) {
-				vec_get(lps, len - 1, &len);
-			} else {
-				vec_set(lps, i, &(size_t){0});
-				i++;
-			}
-		}
-	}
-}
+		if (e->offset < src)
+			goto exit;
 
-vec_index_t str_find(const str_t self, const char *pat)
-{
-	assert(self);
-	assert(pat);
+		src = e->offset + e->delete_len;
+		total -= e->delete_len;
 
-	size_t n;
-	size_t m;
-	size_t i = 0;
-	size_t j = 0;
-	size_t *lps = NULL;
-	vec_index_t pos = NULL;
+		if (total > SIZE_MAX - e->insert_len)
+			goto exit;
 
-	n = str_length(self);
-	m = strlen(pat);
-	if (!m)
-		return NULL;
+		total += e->insert_len;
+	}
 
-	pos = vec_new(sizeof(size_t));
-	if (!pos)
+	str = str_new_len(total);
+	if (!str)
 		goto exit;
 
-	lps = vec_new_len(sizeof(size_t), m);
-	if (!lps)
-		goto exit;
+	src = 0;
+	for (size_t i = 0; i < count; i++) {
+		edit_t *e = sorted_edits + i;
+		size_t keep = e->offset - src;
 
-	kmp_compute_lps(pat, m, lps);
+		memcpy(str + dst, self + src, keep);
+		dst += keep;
 
-	while (i < n) {
-		if (self[i] == pat[j]) {
-			i++;
-			j++;
+		/* removals carry a NULL insert, which memcpy must not see */
+		if (e->insert_len) {
+			memcpy(str + dst, e->insert, e->insert_len);
+			dst += e->insert_len;
 		}
 
-		if (j == m) {
-			pos = vec_extend(pos, 1);
-			if (!pos)
-				goto exit;
-
-			vec_set(pos, vec_count(pos) - 1, &(size_t){i - j});
-			vec_get(lps, j - 1, &j);
-		} else if (i < n && self[i] != pat[j]) {
-			if (j != 0)
-				vec_get(lps, j - 1, &j);
-			else
-				i++;
-		}
+		src = e->offset + e->delete_len;
 	}
 
+	memcpy(str + dst, self + src, len - src);
+
+	str_free(self);
+
 exit:
-	if (lps)
-		vec_free(lps);
+	vec_free(sorted_edits);
 
-	return pos;
+	return str;
 }
 
 str_t str_replace(str_t self, const char *old_str, const char *new_str,
@@ -290,6 +1774,10 @@ str_t str_replace(str_t self, const char *old_str, const char *new_str,
 	if (len_old > str_length(self))
 		return NULL;
 
+	str_edit_t *edits = NULL;
+	size_t num_edits = 0;
+	size_t last_end = 0;
+
 	vec_index_t pos = str_find(self, old_str);
 	if (!pos)
 		return NULL;
@@ -298,60 +1786,33 @@ str_t str_replace(str_t self, const char *old_str, const char *new_str,
 	if (!pos_count)
 		goto exit;
 
-	size_t len_new = strlen(new_str);
-	long long shift = (long long)len_new - (long long)len_old;
-	size_t index, val, self_len, last_end = 0;
+	if ((size_t)count < pos_count)
+		pos_count = (size_t)count;
 
-	for (size_t i = 0; i < pos_count; i++) {
-		if (i >= (size_t)count)
-			break;
-
-		vec_get(pos, i, &index);
+	edits = vec_new_len(sizeof(str_edit_t), pos_count);
+	if (!edits) {
+		self = NULL;
+		goto exit;
+	}
 
-		if (index < last_end)
+	/* overlapping occurrences are not replaced */
+	for (size_t i = 0; i < pos_count; i++) {
+		if (pos[i] < last_end)
 			continue;
 
-		self_len = str_length(self);
-
-	if (shift >= 0) {
-		self = str_extend(self, (size_t)shift);
-		if (!self)
-			goto exit;
-
-		vec_copy(self, index + len_new,
-			vec_ptr_at(self, index + len_old),
-			self_len - index - len_old);
-
-			for (size_t j = i + 1; j < pos_count; j++) {
-				vec_get(pos, j, &val);
-				val += (size_t)shift;
-				vec_set(pos, j, &val);
-			}
-		} else {
-		    size_t remaining = self_len - index - len_old;
-
-		    vec_copy(self, index + len_new,
-			vec_ptr_at(self, index + len_old),
-			remaining);
-
-		    self = str_resize(self, self_len - (size_t)(-1 * shift));
-		    if (!self)
-			goto exit;
-
-		    for (size_t j = i + 1; j < pos_count; j++) {
-			vec_get(pos, j, &val);
-			val -= (size_t)(-shift);
-			vec_set(pos, j, &val);
-		    }
-		}
-
-		for (size_t j = 0; j < len_new; j++)
-			vec_set(self, index + j, new_str + j);
+		edits[num_edits].offset = pos[i];
+		edits[num_edits].delete_len = len_old;
+		edits[num_edits].insert = new_str;
+		num_edits++;
 
-		last_end = index + len_new;
+		last_end = pos[i] + len_old;
 	}
 
+	self = str_apply_edits(self, edits, num_edits);
+
 exit:
+	if (edits)
+		vec_free(edits);
 	if (pos)
 		vec_free(pos);
 
@@ -381,8 +1842,7 @@ str_t str_repeat(str_t self, const size_t count)
 	if (!self)
 		return NULL;
 
-	for (size_t i = 0; i < count; i++)
-		vec_copy(self, i * len, self, len);
+	vec_fill_bytes((uint8_t *)self, len, total);
 
 	return self;
 }
@@ -421,6 +1881,99 @@ str_t str_range(const str_t self, size_t start, size_t end)
 	return str;
 }
 
+str_slice_t str_slice(const str_t self, size_t start, size_t end)
+{
+	assert(self);
+
+	size_t len = str_length(self);
+	size_t temp;
+
+	start = start > len ? len : start;
+	end = end > len ? len : end;
+
+	if (start > end) {
+		temp = start;
+		start = end;
+		end = temp;
+	}
+
+	return (str_slice_t) {
+		.parent = str_ref(self),
+		.start = start,
+		.length = end - start,
+		.cstr = NULL,
+	};
+}
+
+void str_slice_free(str_slice_t *slice)
+{
+	assert(slice);
+
+	if (slice->cstr)
+		str_free(slice->cstr);
+
+	if (slice->parent)
+		str_unref(slice->parent);
+
+	slice->parent = NULL;
+	slice->cstr = NULL;
+	slice->start = 0;
+	slice->length = 0;
+}
+
+const char *str_slice_ptr(const str_slice_t *slice)
+{
+	assert(slice);
+	assert(slice->parent);
+
+	return slice->parent + slice->start;
+}
+
+size_t str_slice_length(const str_slice_t *slice)
+{
+	assert(slice);
+
+	return slice->length;
+}
+
+const char *str_slice_cstr(str_slice_t *slice)
+{
+	assert(slice);
+	assert(slice->parent);
+
+	if (slice->start + slice->length == str_length(slice->parent))
+		return slice->parent + slice->start;
+
+	if (!slice->cstr) {
+		slice->cstr = str_new_len(slice->length);
+		if (!slice->cstr)
+			return NULL;
+
+		memcpy(slice->cstr, slice->parent + slice->start, slice->length);
+	}
+
+	return slice->cstr;
+}
+
+str_t str_slice_str(const str_slice_t *slice)
+{
+	assert(slice);
+	assert(slice->parent);
+
+	str_t str;
+
+	if (!slice->start && slice->length == str_length(slice->parent))
+		return str_ref(slice->parent);
+
+	str = str_new_len(slice->length);
+	if (!str)
+		return NULL;
+
+	memcpy(str, slice->parent + slice->start, slice->length);
+
+	return str;
+}
+
 str_t str_format(str_t self, const char *fmt, ...)
 {
 	assert(fmt);
@@ -533,3 +2086,247 @@ exit:
 
 	return self;
 }
+
+static inline bool parse_i64(const char *s, const size_t len, int64_t *out)
+{
+	size_t i = 0;
+	bool neg = false;
+	uint64_t val = 0;
+	uint64_t limit;
+
+	if (!len)
+		return false;
+
+	if (s[0] == '-' || s[0] == '+') {
+		neg = s[0] == '-';
+		i++;
+	}
+
+	if (i == len)
+		return false;
+
+	limit = neg ? (uint64_t)INT64_MAX + 1 : (uint64_t)INT64_MAX;
+
+	for (; i < len; i++) {
+		uint64_t digit = (uint64_t)(unsigned char)s[i] - '0';
+
+		if (digit > 9)
+			return false;
+
+		if (val > (limit - digit) / 10)
+			return false;
+
+		val = val * 10 + digit;
+	}
+
+	if (neg && val)
+		*out = -(int64_t)(val - 1) - 1;
+	else
+		*out = (int64_t)val;
+
+	return true;
+}
+
+static inline bool parse_double(const char *s, const size_t len,
+				double *out)
+{
+	char buf[BUFSIZE];
+	char *copy = buf;
+	const char *stop;
+	char *end;
+	double val;
+
+	/* strtod() skips leading spaces */
+	if (!len)
+		return false;
+
+	if (s[0] == ' ' || (s[0] >= '\t' && s[0] <= '\r'))
+		return false;
+
+	/*
+	 * Rows are followed by a separator or by the terminator, so strtod()
+	 * runs in place unless the separator itself continues the number.
+	 */
+	errno = 0;
+	val = strtod(s, &end);
+	stop = end;
+
+	if (stop > s + len) {
+		if (len >= BUFSIZE) {
+			copy = malloc(len + 1);
+			if (!copy)
+				return false;
+		}
+
+		memcpy(copy, s, len);
+		copy[len] = '\0';
+
+		errno = 0;
+		val = strtod(copy, &end);
+		stop = s + (end - copy);
+
+		if (copy != buf)
+			free(copy);
+	}
+
+	if (errno || stop != s + len)
+		return false;
+
+	*out = val;
+
+	return true;
+}
+
+static inline void bitmap_set(vec_bitmap_t bitmap, const size_t pos)
+{
+	bitmap[pos / 8] |= (uint8_t)(1U << (pos % 8));
+}
+
+/* allocate the parsed numbers and, if requested, the errors bitmap */
+static vec_t parse_new(const size_t unit_size, const size_t rows,
+		       vec_bitmap_t *errors)
+{
+	vec_t out = vec_new_len(unit_size, rows);
+	if (!out)
+		return NULL;
+
+	if (errors) {
+		*errors = vec_new_len(sizeof(uint8_t), (rows + 7) / 8);
+		if (!*errors) {
+			vec_free(out);
+			return NULL;
+		}
+	}
+
+	return out;
+}
+
+/* count rows first, so output is allocated only once */
+static size_t column_rows(const str_t self, const char *sep,
+			  const size_t sep_len)
+{
+	size_t rows = 0;
+
+	if (str_length(self)) {
+		rows = 1;
+		for (const char *end = strstr(self, sep); end;
+		     end = strstr(end + sep_len, sep))
+			rows++;
+	}
+
+	return rows;
+}
+
+/* return the length of the row starting at `start` */
+static inline size_t column_row(const str_t self, const char *start,
+				const char *sep)
+{
+	const char *end = strstr(start, sep);
+	if (!end)
+		end = self + str_length(self);
+
+	return (size_t)(end - start);
+}
+
+/*
+ * Each parser below runs its own loop, so the element parser is inlined
+ * instead of being called through a pointer for every row.
+ */
+vec_i64_t str_list_parse_i64(const vec_str_t list, vec_bitmap_t *errors)
+{
+	assert(list);
+
+	size_t rows = vec_count(list);
+	vec_i64_t out = parse_new(sizeof(int64_t), rows, errors);
+	if (!out)
+		return NULL;
+
+	vec_bitmap_t bitmap = errors ? *errors : NULL;
+
+	for (size_t i = 0; i < rows; i++) {
+		if (!parse_i64(list[i], str_length(list[i]), out + i) && bitmap)
+			bitmap_set(bitmap, i);
+	}
+
+	return out;
+}
+
+vec_double_t str_list_parse_double(const vec_str_t list, vec_bitmap_t *errors)
+{
+	assert(list);
+
+	size_t rows = vec_count(list);
+	vec_double_t out = parse_new(sizeof(double), rows, errors);
+	if (!out)
+		return NULL;
+
+	vec_bitmap_t bitmap = errors ? *errors : NULL;
+
+	for (size_t i = 0; i < rows; i++) {
+		if (!parse_double(list[i], str_length(list[i]), out + i) &&
+		    bitmap)
+			bitmap_set(bitmap, i);
+	}
+
+	return out;
+}
+
+vec_i64_t str_parse_i64(const str_t self, const char *sep,
+			vec_bitmap_t *errors)
+{
+	assert(self);
+	assert(sep);
+
+	size_t sep_len = strlen(sep);
+	if (!sep_len)
+		return NULL;
+
+	size_t rows = column_rows(self, sep, sep_len);
+	vec_i64_t out = parse_new(sizeof(int64_t), rows, errors);
+	if (!out)
+		return NULL;
+
+	vec_bitmap_t bitmap = errors ? *errors : NULL;
+	const char *start = self;
+
+	for (size_t i = 0; i < rows; i++) {
+		size_t len = column_row(self, start, sep);
+
+		if (!parse_i64(start, len, out + i) && bitmap)
+			bitmap_set(bitmap, i);
+
+		start += len + sep_len;
+	}
+
+	return out;
+}
+
+vec_double_t str_parse_double(const str_t self, const char *sep,
+			      vec_bitmap_t *errors)
+{
+	assert(self);
+	assert(sep);
+
+	size_t sep_len = strlen(sep);
+	if (!sep_len)
+		return NULL;
+
+	size_t rows = column_rows(self, sep, sep_len);
+	vec_double_t out = parse_new(sizeof(double), rows, errors);
+	if (!out)
+		return NULL;
+
+	vec_bitmap_t bitmap = errors ? *errors : NULL;
+	const char *start = self;
+
+	for (size_t i = 0; i < rows; i++) {
+		size_t len = column_row(self, start, sep);
+
+		if (!parse_double(start, len, out + i) && bitmap)
+			bitmap_set(bitmap, i);
+
+		start += len + sep_len;
+	}
+
+	return out;
+}
@@ -8,6 +8,7 @@
 
 #include <stddef.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 /** @brief A simple string. */
 typedef char* str_t;
@@ -18,6 +19,49 @@ typedef str_t* vec_str_t;
 /** @brief An array of indices. */
 typedef size_t* vec_index_t;
 
+/** @brief An array of 64-bit signed integers. */
+typedef int64_t* vec_i64_t;
+
+/** @brief An array of double precision numbers. */
+typedef double* vec_double_t;
+
+/** @brief An array of bits, packed 8 per byte, least significant bit first. */
+typedef uint8_t* vec_bitmap_t;
+
+/** @brief A read-only view on a range of a string.
+ *
+ * A slice holds a reference to its parent string instead of copying the
+ * range. Its fields must be considered private.
+ */
+typedef struct
+{
+	str_t parent;	/* referenced string */
+	size_t start;	/* first byte of the range */
+	size_t length;	/* number of bytes of the range */
+	str_t cstr;	/* terminated copy of the range, created on demand */
+} str_slice_t;
+
+/** @brief A single edit of a string. */
+typedef struct
+{
+	size_t offset;		/* position of the edit in the original string */
+	size_t delete_len;	/* number of bytes to remove at `offset` */
+	const char *insert;	/* C-string to insert at `offset`, or NULL */
+} str_edit_t;
+
+/** @brief A piece of memory to write inside a string. */
+typedef struct
+{
+	const char *ptr;	/* first byte of the piece */
+	size_t len;		/* number of bytes of the piece */
+} str_iovec_t;
+
+/** @brief An array of UTF-16 code units. */
+typedef uint16_t* vec_utf16_t;
+
+/** @brief An array of UTF-32 code points. */
+typedef uint32_t* vec_utf32_t;
+
 /** @brief Create an empty string.
  *
  * @return Pointer to the first character of the string that is a terminator.
@@ -42,9 +86,39 @@ str_t str_new_len(const size_t count);
  */
 str_t str_new(const char* str);
 
-/** @brief Release string memory */
+/** @brief Release string memory.
+ *
+ * Drop a reference to the string, releasing its memory when it was the last
+ * one. It's the same as `str_unref()`.
+ */
 void str_free(str_t self);
 
+/** @brief Share a string.
+ *
+ * Add a reference to the string, so it can be passed to another owner
+ * without copying it. Every reference must be dropped with `str_unref()`.
+ * Functions that modify a shared string work on a private copy and drop the
+ * reference to the shared one, so other owners never see the change.
+ * References can be added and dropped by multiple threads at once.
+ *
+ * @param self The string.
+ * @return The same string.
+ */
+str_t str_ref(str_t self);
+
+/** @brief Drop a reference to a string.
+ *
+ * @param self The string.
+ */
+void str_unref(str_t self);
+
+/** @brief Return true if a string has more than one owner.
+ *
+ * @param self The string.
+ * @return True if `self` is shared. False otherwise.
+ */
+bool str_is_shared(const str_t self);
+
 /** @brief Return the length of a string.
  *
  * @param self The string.
@@ -52,6 +126,72 @@ void str_free(str_t self);
  */
 size_t str_length(const str_t self) __attribute__((pure));
 
+/** @brief Return true if a string contains valid UTF-8 text.
+ *
+ * Overlong encodings, surrogates and code points above U+10FFFF are
+ * rejected. The result is cached inside the string until the library
+ * modifies it, so writing into the string memory directly must be avoided
+ * after calling this function.
+ *
+ * @param self The string.
+ * @return True if `self` is valid UTF-8. False otherwise.
+ */
+bool str_utf8_valid(const str_t self);
+
+/** @brief Return the number of UTF-8 code points inside a string.
+ *
+ * Every byte that is not a UTF-8 continuation byte is counted as a code
+ * point, so the result is meaningful only for valid UTF-8 strings.
+ *
+ * @param self The string.
+ * @return Number of code points inside the string.
+ */
+size_t str_utf8_length(const str_t self) __attribute__((pure));
+
+/** @brief Convert a UTF-8 string into UTF-16 code units.
+ *
+ * Code points outside the Basic Multilingual Plane are encoded as surrogate
+ * pairs. No byte order mark is added.
+ *
+ * @param self The string.
+ * @return Array of UTF-16 code units or NULL if `self` is not valid UTF-8.
+ */
+vec_utf16_t str_to_utf16(const str_t self);
+
+/** @brief Convert a UTF-8 string into UTF-32 code points.
+ *
+ * @param self The string.
+ * @return Array of code points or NULL if `self` is not valid UTF-8.
+ */
+vec_utf32_t str_to_utf32(const str_t self);
+
+/** @brief Create a UTF-8 string from UTF-16 code units.
+ *
+ * @param vec Array of UTF-16 code units.
+ * @return New string or NULL if `vec` contains unpaired surrogates.
+ */
+str_t str_from_utf16(const vec_utf16_t vec);
+
+/** @brief Create a UTF-8 string from UTF-32 code points.
+ *
+ * @param vec Array of code points.
+ * @return New string or NULL if `vec` contains surrogates or code points
+ *         above U+10FFFF.
+ */
+str_t str_from_utf32(const vec_utf32_t vec);
+
+/** @brief Return the hash of a string.
+ *
+ * Compute a fast non-cryptographic 64-bit hash of the string content. The
+ * result is cached inside the string until the library modifies it, so
+ * repeated calls on the same string cost nothing. Hash values are not
+ * stable across library versions or platforms of different endianness.
+ *
+ * @param self The string.
+ * @return Hash of the string.
+ */
+uint64_t str_hash(const str_t self);
+
 /** @brief Insert a C-string in a specific position of a string.
  *
  * Insert `str` at `pos` of `self`.
@@ -73,6 +213,37 @@ str_t str_insert(str_t self, const size_t pos, const char *str);
  */
 str_t str_append(str_t self, const char *str);
 
+/** @brief Append multiple C-strings to a string.
+ *
+ * Append all the C-strings to `self`, computing the final length first so
+ * that the string is extended only once.
+ *
+ * @param self The string.
+ * @param ... C-strings to add, terminated by NULL.
+ * @return Pointer to the first character of the string.
+ */
+str_t str_concat(str_t self, ...);
+
+/** @brief Append multiple pieces of memory to a string.
+ *
+ * Append `count` pieces to `self`, extending the string only once. Pieces
+ * don't need to be terminated.
+ *
+ * @param self The string.
+ * @param pieces Array of pieces.
+ * @param count Number of pieces.
+ * @return Pointer to the first character of the string.
+ */
+str_t str_writev(str_t self, const str_iovec_t *pieces, const size_t count);
+
+/** @brief Join an array of strings using a separator.
+ *
+ * @param list Array of strings.
+ * @param sep Separator placed between consecutive strings.
+ * @return New string.
+ */
+str_t str_join(const vec_str_t list, const char *sep);
+
 /** @brief Clear a string.
  *
  * Resize the string to 0 length.
@@ -84,7 +255,8 @@ str_t str_clear(str_t self);
 
 /** @brief Split a string into multiple substrings according to the separator.
  *
- * Split `self` into multiple substrings according to `sep`.
+ * Split `self` into multiple substrings according to `sep`. Every byte of
+ * `sep` is a separator and empty substrings are not returned.
  *
  * @param self The string.
  * @param sep Separator.
@@ -92,6 +264,45 @@ str_t str_clear(str_t self);
  */
 vec_str_t str_split(const str_t self, const char *sep);
 
+/** @brief Return the length of the initial part of a string made of bytes
+ * inside a set.
+ *
+ * @param self The string.
+ * @param charset C-string containing the set of bytes.
+ * @return Number of leading bytes of `self` that are inside `charset`.
+ */
+size_t str_span(const str_t self, const char *charset);
+
+/** @brief Return the length of the initial part of a string made of bytes
+ * outside a set.
+ *
+ * @param self The string.
+ * @param charset C-string containing the set of bytes.
+ * @return Number of leading bytes of `self` that are not inside `charset`.
+ */
+size_t str_cspan(const str_t self, const char *charset);
+
+/** @brief Remove leading whitespaces from a string.
+ *
+ * @param self The string.
+ * @return Pointer to the first character of the string.
+ */
+str_t str_ltrim(str_t self);
+
+/** @brief Remove trailing whitespaces from a string.
+ *
+ * @param self The string.
+ * @return Pointer to the first character of the string.
+ */
+str_t str_rtrim(str_t self);
+
+/** @brief Remove leading and trailing whitespaces from a string.
+ *
+ * @param self The string.
+ * @return Pointer to the first character of the string.
+ */
+str_t str_trim(str_t self);
+
 /** @brief Release an array of strings.
  *
  * @param list Array of strings.
@@ -128,6 +339,85 @@ bool str_endswith(const str_t self, const char *sub) __attribute__((pure));
  */
 vec_index_t str_find(const str_t self, const char *pat);
 
+/** @brief Find a substring inside a string, ignoring ASCII case.
+ *
+ * Find `pat` inside `self`, comparing ASCII letters case-insensitively.
+ * Other bytes must match exactly.
+ *
+ * @param self The string.
+ * @param pat Substring of the string.
+ * @return Indices where `pat` is located inside `self`.
+ */
+vec_index_t str_find_icase(const str_t self, const char *pat);
+
+/** @brief Find a substring inside a string, using multiple threads.
+ *
+ * The string is split in chunks which are searched on the default thread
+ * pool. Chunks are extended by the length of `pat` minus one, so matches
+ * crossing their boundaries are found too, and the result is the same of
+ * `str_find()`. Short strings are searched by the calling thread only.
+ *
+ * @param self The string.
+ * @param pat Substring of the string.
+ * @param nthreads Maximum number of chunks. If 0, the number of threads of
+ *	the default pool.
+ * @return Indices where `pat` is located inside `self`.
+ */
+vec_index_t str_find_parallel(const str_t self, const char *pat,
+			      size_t nthreads);
+
+/** @brief Return true if a string starts with a substring, ignoring ASCII
+ * case.
+ *
+ * @param self The string.
+ * @param sub Substring of the string.
+ * @return True if `sub` is at the beginning of `self`. False otherwise.
+ */
+bool str_startswith_icase(const str_t self, const char *sub)
+	__attribute__((pure));
+
+/** @brief Return true if a string ends with a substring, ignoring ASCII
+ * case.
+ *
+ * @param self The string.
+ * @param sub Substring of the string.
+ * @return True if `sub` is at the end of `self`. False otherwise.
+ */
+bool str_endswith_icase(const str_t self, const char *sub)
+	__attribute__((pure));
+
+/** @brief Convert ASCII letters of a string to lower case.
+ *
+ * The string is modified in place. Non-ASCII bytes are left untouched.
+ *
+ * @param self The string.
+ * @return Pointer to the first character of the string.
+ */
+str_t str_to_lower(str_t self);
+
+/** @brief Convert ASCII letters of a string to upper case.
+ *
+ * The string is modified in place. Non-ASCII bytes are left untouched.
+ *
+ * @param self The string.
+ * @return Pointer to the first character of the string.
+ */
+str_t str_to_upper(str_t self);
+
+/** @brief Apply a list of edits to a string.
+ *
+ * Offsets refer to the original string, so edits don't depend on each other
+ * and they can be passed in any order. Edits at the same offset are applied
+ * in the given order. The result is built with a single allocation.
+ *
+ * @param self The string.
+ * @param edits Array of edits.
+ * @param count Number of edits.
+ * @return String with the applied edits or NULL if edits overlap or they are
+ *         out of the string. In that case, `self` is not modified.
+ */
+str_t str_apply_edits(str_t self, const str_edit_t *edits, const size_t count);
+
 /** @brief Replace a substring with an another substring inside a string.
  *
  * Replace `old_str` with `new_str` inside `self` for `count` times.
@@ -171,6 +461,63 @@ str_t str_repeat(str_t self, const size_t count);
  */
 str_t str_range(const str_t self, size_t start, size_t end);
 
+/** @brief Return a slice sharing a range of a string.
+ *
+ * The range is handled as in `str_range()`, but bytes are not copied: the
+ * slice keeps a reference to `self`, so further changes to `self` made by
+ * string functions are not visible inside the slice.
+ *
+ * @param self The string.
+ * @param start Lower location in `self`.
+ * @param end Upper location in `self`.
+ * @return Slice of `self` within `start` and `end` range.
+ */
+str_slice_t str_slice(const str_t self, size_t start, size_t end);
+
+/** @brief Release a slice.
+ *
+ * @param slice The slice.
+ */
+void str_slice_free(str_slice_t *slice);
+
+/** @brief Return the first byte of a slice.
+ *
+ * The returned memory is not terminated, unless the slice reaches the end of
+ * its parent.
+ *
+ * @param slice The slice.
+ * @return Pointer to the first byte of the slice.
+ */
+const char *str_slice_ptr(const str_slice_t *slice) __attribute__((pure));
+
+/** @brief Return the length of a slice.
+ *
+ * @param slice The slice.
+ * @return Number of bytes inside the slice.
+ */
+size_t str_slice_length(const str_slice_t *slice) __attribute__((pure));
+
+/** @brief Return a slice as a terminated C-string.
+ *
+ * When the slice reaches the end of its parent, the parent terminator is
+ * used. Otherwise, the range is copied only once, at the first call, and
+ * kept until the slice is released.
+ *
+ * @param slice The slice.
+ * @return C-string or NULL if memory can't be allocated.
+ */
+const char *str_slice_cstr(str_slice_t *slice);
+
+/** @brief Create a string from a slice.
+ *
+ * When the slice covers its whole parent, a new reference to the parent is
+ * returned instead of a copy.
+ *
+ * @param slice The slice.
+ * @return String with the content of the slice.
+ */
+str_t str_slice_str(const str_slice_t *slice);
+
 /** @brief Create a string according to formatter syntax.
  *
  * Uses a printf-like format syntax to create a string. String is cleared
@@ -189,4 +536,60 @@ str_t str_range(const str_t self, size_t start, size_t end);
  */
 str_t str_format(str_t self, const char *fmt, ...);
 
+/** @brief Parse an array of strings into 64-bit signed integers.
+ *
+ * Each string must contain an optional sign followed by decimal digits only,
+ * without surrounding spaces. Rows that can't be parsed are set to 0 and
+ * flagged inside `errors`.
+ *
+ * @param list Array of strings.
+ * @param errors If not NULL, it's set to a new bitmap having one bit for each
+ *               row, which is set when the row could not be parsed.
+ * @return Array of numbers having the same count of `list`.
+ */
+vec_i64_t str_list_parse_i64(const vec_str_t list, vec_bitmap_t *errors);
+
+/** @brief Parse an array of strings into double precision numbers.
+ *
+ * Each string must contain a floating point number in the format accepted by
+ * `strtod()`, without surrounding spaces. Rows that can't be parsed are set
+ * to 0 and flagged inside `errors`.
+ *
+ * @param list Array of strings.
+ * @param errors If not NULL, it's set to a new bitmap having one bit for each
+ *               row, which is set when the row could not be parsed.
+ * @return Array of numbers having the same count of `list`.
+ */
+vec_double_t str_list_parse_double(const vec_str_t list, vec_bitmap_t *errors);
+
+/** @brief Parse a separated column of 64-bit signed integers.
+ *
+ * Every occurrence of `sep` inside `self` delimits a row, so empty rows are
+ * reported as errors. An empty string has no rows. Numbers are parsed as in
+ * `str_list_parse_i64()`, without creating intermediate strings.
+ *
+ * @param self The string.
+ * @param sep Rows separator.
+ * @param errors If not NULL, it's set to a new bitmap having one bit for each
+ *               row, which is set when the row could not be parsed.
+ * @return Array of numbers.
+ */
+vec_i64_t str_parse_i64(const str_t self, const char *sep,
+			vec_bitmap_t *errors);
+
+/** @brief Parse a separated column of double precision numbers.
+ *
+ * Every occurrence of `sep` inside `self` delimits a row, so empty rows are
+ * reported as errors. An empty string has no rows. Numbers are parsed as in
+ * `str_list_parse_double()`, without creating intermediate strings.
+ *
+ * @param self The string.
+ * @param sep Rows separator.
+ * @param errors If not NULL, it's set to a new bitmap having one bit for each
+ *               row, which is set when the row could not be parsed.
+ * @return Array of numbers.
+ */
+vec_double_t str_parse_double(const str_t self, const char *sep,
+			      vec_bitmap_t *errors);
+
 #endif
@@ -0,0 +1,133 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (c) 2025 Andrea Cervesato <andrea.cervesato@mailbox.org>
+ */
+
+#include "gap.h"
+#include "str.h"
+#include "utils.h"
+#include <string.h>
+#include <stdlib.h>
+#include <assert.h>
+
+static void assert_gap_equal(str_gap_t gap, const char *expected)
+{
+	str_t str = str_gap_to_str(gap);
+
+	assert(str);
+	assert(str_gap_length(gap) == strlen(expected));
+	assert(strcmp(str, expected) == 0);
+
+	str_free(str);
+}
+
+static void test_str_gap_new(void)
+{
+	str_gap_t gap = str_gap_new("hello");
+
+	assert(gap);
+	assert(str_gap_length(gap) == 5);
+	assert(str_gap_cursor(gap) == 5);
+	assert_gap_equal(gap, "hello");
+
+	str_gap_free(gap);
+
+	gap = str_gap_new("");
+	assert(gap);
+	assert(str_gap_length(gap) == 0);
+	assert_gap_equal(gap, "");
+
+	str_gap_free(gap);
+}
+
+static void test_str_gap_insert(void)
+{
+	str_gap_t gap = str_gap_new("ciao");
+	bool ret;
+
+	ret = str_gap_insert(gap, " mondo");
+	assert(ret);
+	assert_gap_equal(gap, "ciao mondo");
+
+	str_gap_move(gap, 0);
+	ret = str_gap_insert(gap, ">> ");
+	assert(ret);
+	assert(str_gap_cursor(gap) == 3);
+	assert_gap_equal(gap, ">> ciao mondo");
+
+	str_gap_move(gap, 7);
+	ret = str_gap_insert(gap, ",");
+	assert(ret);
+	assert_gap_equal(gap, ">> ciao, mondo");
+
+	str_gap_move(gap, 100);
+	assert(str_gap_cursor(gap) == 14);
+
+	str_gap_free(gap);
+}
+
+static void test_str_gap_delete(void)
+{
+	str_gap_t gap = str_gap_new("hello big world");
+
+	str_gap_move(gap, 5);
+	str_gap_delete(gap, 4);
+	assert_gap_equal(gap, "hello world");
+
+	str_gap_backspace(gap, 2);
+	assert_gap_equal(gap, "hel world");
+	assert(str_gap_cursor(gap) == 3);
+
+	str_gap_backspace(gap, 100);
+	assert_gap_equal(gap, " world");
+
+	str_gap_delete(gap, 100);
+	assert_gap_equal(gap, "");
+
+	str_gap_free(gap);
+}
+
+static void test_str_gap_at(void)
+{
+	str_gap_t gap = str_gap_new("abcdef");
+
+	str_gap_move(gap, 3);
+
+	for (size_t i = 0; i < 6; i++)
+		assert(str_gap_at(gap, i) == (char)('a' + i));
+
+	assert(str_gap_at(gap, 6) == '\0');
+
+	str_gap_free(gap);
+}
+
+static void test_str_gap_many_inserts(void)
+{
+	str_gap_t gap = str_gap_new("[]");
+	str_t ref = str_new("[]");
+	bool ret;
+
+	str_gap_move(gap, 1);
+
+	for (size_t i = 0; i < 10000; i++) {
+		ret = str_gap_insert(gap, "ab");
+		assert(ret);
+		ref = str_insert(ref, 1 + i * 2, "ab");
+	}
+
+	assert_gap_equal(gap, ref);
+
+	str_free(ref);
+	str_gap_free(gap);
+}
+
+int main(void)
+{
+	RUN_TEST(test_str_gap_new);
+	RUN_TEST(test_str_gap_insert);
+	RUN_TEST(test_str_gap_delete);
+	RUN_TEST(test_str_gap_at);
+	RUN_TEST(test_str_gap_many_inserts);
+
+	return 0;
+}
@@ -0,0 +1,186 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (c) 2025 Andrea Cervesato <andrea.cervesato@mailbox.org>
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "intern.h"
+#include "str.h"
+#include "vec.h"
+#include "utils.h"
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+
+#define THREADS 4
+
+static void test_str_intern_new(void)
+{
+	str_intern_t pool = str_intern_new();
+
+	assert(pool);
+	assert(str_intern_count(pool) == 0);
+
+	str_intern_free(pool);
+}
+
+static void test_str_intern_same(void)
+{
+	str_intern_t pool = str_intern_new();
+	str_t a = str_new("tag");
+	str_t b = str_new("tag");
+	str_t c = str_new("other");
+	str_t ia, ib, ic;
+
+	ia = str_intern(pool, a);
+	ib = str_intern(pool, b);
+	ic = str_intern(pool, c);
+
+	assert(ia);
+	assert(ia == ib);
+	assert(ia != ic);
+	assert(ia != a);
+	assert(strcmp(ia, "tag") == 0);
+	assert(str_length(ia) == 3);
+	assert(str_hash(ia) == str_hash(a));
+	assert(str_intern_count(pool) == 2);
+
+	str_free(c);
+	str_free(b);
+	str_free(a);
+	str_intern_free(pool);
+}
+
+static void test_str_intern_lookup(void)
+{
+	str_intern_t pool = str_intern_new();
+	str_t a = str_new("tag");
+	str_t ia;
+
+	assert(str_intern_lookup(pool, a) == NULL);
+	ia = str_intern(pool, a);
+	assert(ia == str_intern_lookup(pool, a));
+
+	str_free(a);
+	str_intern_free(pool);
+}
+
+static void test_str_intern_split(void)
+{
+	str_intern_t pool = str_intern_new();
+	str_t str = str_new("a b c a b c ");
+	vec_str_t tok;
+
+	str = str_repeat(str, 1000);
+	tok = str_split(str, " ");
+	assert(vec_count(tok) == 6000);
+
+	for (size_t i = 0; i < vec_count(tok); i++) {
+		str_t ia = str_intern(pool, tok[i]);
+		str_t ib = str_intern(pool, tok[i % 3]);
+
+		assert(ia == ib);
+	}
+
+	assert(str_intern_count(pool) == 3);
+
+	str_list_free(tok);
+	str_free(str);
+	str_intern_free(pool);
+}
+
+static void test_str_intern_many(void)
+{
+	str_intern_t pool = str_intern_new();
+	str_t key = str_empty();
+	vec_str_t interned = vec_new_len(sizeof(str_t), 5000);
+
+	for (size_t i = 0; i < 5000; i++) {
+		key = str_format(key, "tag-%u", (unsigned long long)i);
+		interned[i] = str_intern(pool, key);
+		assert(interned[i]);
+	}
+
+	/* pointers never move, even when the pool grows */
+	for (size_t i = 0; i < 5000; i++) {
+		key = str_format(key, "tag-%u", (unsigned long long)i);
+		assert(str_intern_lookup(pool, key) == interned[i]);
+		assert(strcmp(interned[i], key) == 0);
+	}
+
+	assert(str_intern_count(pool) == 5000);
+
+	vec_free(interned);
+	str_free(key);
+	str_intern_free(pool);
+}
+
+static void *intern_worker(void *arg)
+{
+	str_intern_t pool = arg;
+	str_t key = str_empty();
+
+	for (size_t i = 0; i < 2000; i++) {
+		key = str_format(key, "tag-%u", (unsigned long long)(i % 500));
+		str_t found = str_intern(pool, key);
+		assert(found);
+		assert(strcmp(found, key) == 0);
+		assert(str_intern_lookup(pool, key) == found);
+	}
+
+	str_free(key);
+
+	return NULL;
+}
+
+static void test_str_intern_threads(void)
+{
+	str_intern_t pool = str_intern_new();
+	pthread_t threads[THREADS];
+
+	for (size_t i = 0; i < THREADS; i++)
+		pthread_create(&threads[i], NULL, intern_worker, pool);
+
+	for (size_t i = 0; i < THREADS; i++)
+		pthread_join(threads[i], NULL);
+
+	assert(str_intern_count(pool) == 500);
+
+	str_intern_free(pool);
+}
+
+static void test_str_intern_immutable(void)
+{
+	str_intern_t pool = str_intern_new();
+	str_t a = str_new("tag");
+	str_t ia = str_intern(pool, a);
+	str_t copy;
+
+	assert(str_is_shared(ia));
+
+	copy = str_append(ia, "s");
+	assert(copy != ia);
+	assert(strcmp(copy, "tags") == 0);
+	assert(strcmp(ia, "tag") == 0);
+
+	str_free(ia);
+	assert(str_intern_lookup(pool, a) == ia);
+
+	str_free(copy);
+	str_free(a);
+	str_intern_free(pool);
+}
+
+int main(void)
+{
+	RUN_TEST(test_str_intern_new);
+	RUN_TEST(test_str_intern_same);
+	RUN_TEST(test_str_intern_lookup);
+	RUN_TEST(test_str_intern_split);
+	RUN_TEST(test_str_intern_many);
+	RUN_TEST(test_str_intern_threads);
+	RUN_TEST(test_str_intern_immutable);
+
+	return 0;
+}
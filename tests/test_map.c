@@ -0,0 +1,204 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (c) 2025 Andrea Cervesato <andrea.cervesato@mailbox.org>
+ */
+
+#include "map.h"
+#include "str.h"
+#include "vec.h"
+#include "utils.h"
+#include <string.h>
+#include <assert.h>
+#include <stdint.h>
+
+static void test_map_new(void)
+{
+	map_t map = map_new(sizeof(int));
+
+	assert(map);
+	assert(map_count(map) == 0);
+
+	map_free(map);
+}
+
+static void test_map_set_get(void)
+{
+	map_t map = map_new(sizeof(int));
+	str_t key = str_new("hello");
+	int *value;
+	bool ret;
+
+	ret = map_set(map, key, &(int){42});
+	assert(ret);
+	assert(map_count(map) == 1);
+
+	value = map_get(map, key);
+	assert(value);
+	assert(*value == 42);
+
+	str_free(key);
+	map_free(map);
+}
+
+static void test_map_overwrite(void)
+{
+	map_t map = map_new(sizeof(int));
+	str_t key = str_new("hello");
+	str_t same = str_new("hello");
+	bool ret;
+
+	ret = map_set(map, key, &(int){1});
+	assert(ret);
+	ret = map_set(map, same, &(int){2});
+	assert(ret);
+	assert(map_count(map) == 1);
+	assert(*(int *)map_get(map, key) == 2);
+
+	str_free(same);
+	str_free(key);
+	map_free(map);
+}
+
+static void test_map_get_missing(void)
+{
+	map_t map = map_new(sizeof(int));
+	str_t key = str_new("hello");
+	str_t other = str_new("world");
+	bool ret;
+
+	assert(map_get(map, key) == NULL);
+	ret = map_set(map, key, &(int){1});
+	assert(ret);
+	assert(map_get(map, other) == NULL);
+
+	str_free(other);
+	str_free(key);
+	map_free(map);
+}
+
+static void test_map_many(void)
+{
+	map_t map = map_new(sizeof(size_t));
+	str_t key = str_empty();
+	size_t *value;
+	bool ret;
+
+	for (size_t i = 0; i < 10000; i++) {
+		key = str_format(key, "key-%u", (unsigned long long)i);
+		ret = map_set(map, key, &i);
+		assert(ret);
+	}
+
+	assert(map_count(map) == 10000);
+
+	for (size_t i = 0; i < 10000; i++) {
+		key = str_format(key, "key-%u", (unsigned long long)i);
+		value = map_get(map, key);
+		assert(value);
+		assert(*value == i);
+	}
+
+	str_free(key);
+	map_free(map);
+}
+
+static void test_map_remove(void)
+{
+	map_t map = map_new(sizeof(size_t));
+	str_t key = str_empty();
+	bool ret;
+
+	/* repeated insert and remove must reuse tombstones */
+	for (size_t round = 0; round < 20; round++) {
+		for (size_t i = 0; i < 100; i++) {
+			key = str_format(key, "%u-%u",
+					 (unsigned long long)round,
+					 (unsigned long long)i);
+			ret = map_set(map, key, &i);
+			assert(ret);
+		}
+
+		for (size_t i = 0; i < 100; i++) {
+			key = str_format(key, "%u-%u",
+					 (unsigned long long)round,
+					 (unsigned long long)i);
+			ret = map_remove(map, key);
+			assert(ret);
+			ret = map_remove(map, key);
+			assert(!ret);
+			assert(map_get(map, key) == NULL);
+		}
+	}
+
+	assert(map_count(map) == 0);
+
+	str_free(key);
+	map_free(map);
+}
+
+static void test_map_next(void)
+{
+	map_t map = map_new(sizeof(int));
+	str_t key = str_empty();
+	size_t iter = 0;
+	size_t count = 0;
+	int sum = 0;
+	str_t k;
+	void *v;
+	bool ret;
+
+	for (int i = 0; i < 50; i++) {
+		key = str_format(key, "%i", i);
+		ret = map_set(map, key, &i);
+		assert(ret);
+	}
+
+	while (map_next(map, &iter, &k, &v)) {
+		assert(*(int *)map_get(map, k) == *(int *)v);
+		sum += *(int *)v;
+		count++;
+	}
+
+	assert(count == 50);
+	assert(sum == 49 * 50 / 2);
+
+	str_free(key);
+	map_free(map);
+}
+
+static void test_map_large_value(void)
+{
+	struct record { char name[32]; double value; } rec, *out;
+	map_t map = map_new(sizeof(struct record));
+	str_t key = str_new("pi");
+	bool ret;
+
+	memset(&rec, 0, sizeof(rec));
+	strcpy(rec.name, "pi");
+	rec.value = 3.14;
+
+	ret = map_set(map, key, &rec);
+	assert(ret);
+
+	out = map_get(map, key);
+	assert(out);
+	assert(strcmp(out->name, "pi") == 0);
+	assert(out->value > 3.13 && out->value < 3.15);
+
+	str_free(key);
+	map_free(map);
+}
+
+int main(void)
+{
+	RUN_TEST(test_map_new);
+	RUN_TEST(test_map_set_get);
+	RUN_TEST(test_map_overwrite);
+	RUN_TEST(test_map_get_missing);
+	RUN_TEST(test_map_many);
+	RUN_TEST(test_map_remove);
+	RUN_TEST(test_map_next);
+	RUN_TEST(test_map_large_value);
+
+	return 0;
+}
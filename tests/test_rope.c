@@ -0,0 +1,194 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (c) 2025 Andrea Cervesato <andrea.cervesato@mailbox.org>
+ */
+
+#include "rope.h"
+#include "str.h"
+#include "vec.h"
+#include "utils.h"
+#include <string.h>
+#include <stdlib.h>
+#include <assert.h>
+
+static void assert_rope_equal(str_rope_t rope, const char *expected)
+{
+	str_t flat = str_rope_flatten(rope);
+
+	assert(flat);
+	assert(str_rope_length(rope) == strlen(expected));
+	assert(str_length(flat) == strlen(expected));
+	assert(strcmp(flat, expected) == 0);
+
+	str_free(flat);
+}
+
+static void test_str_rope_new(void)
+{
+	str_rope_t rope = str_rope_new();
+
+	assert(rope);
+	assert(str_rope_length(rope) == 0);
+	assert_rope_equal(rope, "");
+
+	str_rope_free(rope);
+}
+
+static void test_str_rope_new_str(void)
+{
+	str_rope_t rope = str_rope_new_str("hello world");
+
+	assert(rope);
+	assert_rope_equal(rope, "hello world");
+	assert(str_rope_at(rope, 4) == 'o');
+	assert(str_rope_at(rope, 11) == '\0');
+
+	str_rope_free(rope);
+}
+
+static void test_str_rope_insert(void)
+{
+	str_rope_t rope = str_rope_new_str("ciao");
+	bool ret;
+
+	ret = str_rope_insert(rope, 0, "mondo ");
+	assert(ret);
+	assert_rope_equal(rope, "mondo ciao");
+
+	ret = str_rope_insert(rope, 5, ",");
+	assert(ret);
+	assert_rope_equal(rope, "mondo, ciao");
+
+	ret = str_rope_append(rope, "!");
+	assert(ret);
+	assert_rope_equal(rope, "mondo, ciao!");
+
+	ret = str_rope_insert(rope, 100, "x");
+	assert(!ret);
+	assert_rope_equal(rope, "mondo, ciao!");
+
+	str_rope_free(rope);
+}
+
+static void test_str_rope_remove(void)
+{
+	str_rope_t rope = str_rope_new_str("hello big world");
+	bool ret;
+
+	ret = str_rope_remove(rope, 5, 4);
+	assert(ret);
+	assert_rope_equal(rope, "hello world");
+
+	ret = str_rope_remove(rope, 5, 100);
+	assert(ret);
+	assert_rope_equal(rope, "hello");
+
+	ret = str_rope_remove(rope, 10, 1);
+	assert(ret);
+	assert_rope_equal(rope, "hello");
+
+	ret = str_rope_remove(rope, 0, 5);
+	assert(ret);
+	assert_rope_equal(rope, "");
+
+	str_rope_free(rope);
+}
+
+static void test_str_rope_concat(void)
+{
+	str_rope_t a = str_rope_new_str("hello ");
+	str_rope_t b = str_rope_new_str("world");
+	bool ret;
+
+	ret = str_rope_concat(a, b);
+	assert(ret);
+	assert_rope_equal(a, "hello world");
+	assert_rope_equal(b, "");
+
+	str_rope_free(b);
+	str_rope_free(a);
+}
+
+static void test_str_rope_next(void)
+{
+	str_t big = str_new("0123456789");
+	str_rope_t rope;
+	size_t iter = 0;
+	size_t total = 0;
+	size_t len;
+	const char *chunk;
+
+	big = str_repeat(big, 500);
+	rope = str_rope_new_str(big);
+
+	while ((chunk = str_rope_next(rope, &iter, &len))) {
+		assert(len > 0);
+		assert(memcmp(chunk, big + total, len) == 0);
+		total += len;
+	}
+
+	assert(total == 5000);
+
+	str_rope_free(rope);
+	str_free(big);
+}
+
+static void test_str_rope_random_edits(void)
+{
+	str_rope_t rope = str_rope_new();
+	str_t ref = str_empty();
+	char piece[64];
+	bool ret;
+
+	srand(1);
+
+	for (size_t i = 0; i < 3000; i++) {
+		size_t len = str_length(ref);
+		size_t pos = len ? (size_t)rand() % (len + 1) : 0;
+
+		if (rand() % 3) {
+			size_t n = 1 + (size_t)rand() % (sizeof(piece) - 1);
+
+			for (size_t j = 0; j < n; j++)
+				piece[j] = (char)('a' + rand() % 26);
+			piece[n] = '\0';
+
+			ret = str_rope_insert(rope, pos, piece);
+			assert(ret);
+			ref = str_insert(ref, pos, piece);
+		} else {
+			size_t n = (size_t)rand() % 100;
+			str_t head = str_range(ref, 0, pos);
+			str_t tail = str_range(ref, pos + n, len);
+
+			ret = str_rope_remove(rope, pos, n);
+			assert(ret);
+			str_free(ref);
+			ref = str_append(head, tail);
+			str_free(tail);
+		}
+
+		assert(str_rope_length(rope) == str_length(ref));
+	}
+
+	assert_rope_equal(rope, ref);
+
+	for (size_t i = 0; i < str_length(ref); i += 7)
+		assert(str_rope_at(rope, i) == ref[i]);
+
+	str_free(ref);
+	str_rope_free(rope);
+}
+
+int main(void)
+{
+	RUN_TEST(test_str_rope_new);
+	RUN_TEST(test_str_rope_new_str);
+	RUN_TEST(test_str_rope_insert);
+	RUN_TEST(test_str_rope_remove);
+	RUN_TEST(test_str_rope_concat);
+	RUN_TEST(test_str_rope_next);
+	RUN_TEST(test_str_rope_random_edits);
+
+	return 0;
+}
@@ -10,6 +10,15 @@
 #include <assert.h>
 #include <stdint.h>
 
+/* parsed doubles are compared with a relative tolerance */
+static bool same_double(const double a, const double b)
+{
+	double diff = a > b ? a - b : b - a;
+	double mag = b < 0 ? -b : b;
+
+	return diff <= 1e-12 * (mag + 1);
+}
+
 static void test_str_empty(void)
 {
 	str_t str = str_empty();
@@ -929,6 +938,837 @@ static void test_str_split_no_leak_verify(void)
 	str_free(str);
 }
 
+static void test_str_list_parse_i64(void)
+{
+	str_t str = str_new("12 -7 +3 abc 9223372036854775807 -9223372036854775808 9223372036854775808");
+	vec_str_t tok = str_split(str, " ");
+	vec_bitmap_t errors;
+	vec_i64_t num;
+
+	num = str_list_parse_i64(tok, &errors);
+	assert(num);
+	assert(errors);
+	assert(vec_count(num) == 7);
+	assert(num[0] == 12);
+	assert(num[1] == -7);
+	assert(num[2] == 3);
+	assert(num[3] == 0);
+	assert(num[4] == INT64_MAX);
+	assert(num[5] == INT64_MIN);
+	assert(num[6] == 0);
+	assert(errors[0] == ((1 << 3) | (1 << 6)));
+
+	vec_free(errors);
+	vec_free(num);
+	str_list_free(tok);
+	str_free(str);
+}
+
+static void test_str_list_parse_double(void)
+{
+	str_t str = str_new("1.5,-2e3,x,0.25");
+	vec_str_t tok = str_split(str, ",");
+	vec_bitmap_t errors;
+	vec_double_t num;
+
+	num = str_list_parse_double(tok, &errors);
+	assert(num);
+	assert(vec_count(num) == 4);
+	assert(same_double(num[0], 1.5));
+	assert(same_double(num[1], -2e3));
+	assert(same_double(num[2], 0));
+	assert(same_double(num[3], 0.25));
+	assert(errors[0] == (1 << 2));
+
+	vec_free(errors);
+	vec_free(num);
+	str_list_free(tok);
+	str_free(str);
+}
+
+static void test_str_parse_i64(void)
+{
+	str_t str = str_new("1\n\n-3\n 4\n5");
+	vec_bitmap_t errors;
+	vec_i64_t num;
+
+	num = str_parse_i64(str, "\n", &errors);
+	assert(num);
+	assert(vec_count(num) == 5);
+	assert(num[0] == 1);
+	assert(num[2] == -3);
+	assert(num[4] == 5);
+	assert(errors[0] == ((1 << 1) | (1 << 3)));
+
+	vec_free(errors);
+	vec_free(num);
+	str_free(str);
+}
+
+static void test_str_parse_double(void)
+{
+	str_t str = str_new("0.5::1e-2::7");
+	vec_double_t num;
+
+	num = str_parse_double(str, "::", NULL);
+	assert(num);
+	assert(vec_count(num) == 3);
+	assert(same_double(num[0], 0.5));
+	assert(same_double(num[1], 1e-2));
+	assert(same_double(num[2], 7));
+
+	vec_free(num);
+	str_free(str);
+}
+
+static void test_str_parse_double_long(void)
+{
+	char row[128];
+	str_t str;
+	vec_double_t num;
+
+	/* rows longer than any internal buffer are still parsed */
+	memset(row, '0', sizeof(row));
+	row[1] = '.';
+	row[sizeof(row) - 2] = '1';
+	row[sizeof(row) - 1] = '\0';
+
+	str = str_new(row);
+	str = str_append(str, ",");
+	str = str_append(str, row);
+	num = str_parse_double(str, ",", NULL);
+	assert(num);
+	assert(vec_count(num) == 2);
+	assert(same_double(num[0], 1e-125));
+	assert(same_double(num[1], 1e-125));
+	vec_free(num);
+	str_free(str);
+
+	/* a separator which would continue the number still splits rows */
+	str = str_new(row);
+	str = str_append(str, "e2e7");
+	num = str_parse_double(str, "e", NULL);
+	assert(num);
+	assert(vec_count(num) == 3);
+	assert(same_double(num[0], 1e-125));
+	assert(same_double(num[1], 2));
+	assert(same_double(num[2], 7));
+	vec_free(num);
+	str_free(str);
+}
+
+static void test_str_parse_empty(void)
+{
+	str_t str = str_empty();
+	vec_bitmap_t errors;
+	vec_i64_t num;
+
+	num = str_parse_i64(str, ",", &errors);
+	assert(num);
+	assert(errors);
+	assert(vec_count(num) == 0);
+	assert(vec_count(errors) == 0);
+
+	assert(str_parse_i64(str, "", NULL) == NULL);
+
+	vec_free(errors);
+	vec_free(num);
+	str_free(str);
+}
+
+static void test_str_utf8_valid(void)
+{
+	const char *valid[] = {
+		"", "ascii", "\xc3\xa8", "\xe2\x82\xac", "\xf0\x9f\x98\x80",
+		"\xed\x9f\xbf", "\xf4\x8f\xbf\xbf", "caf\xc3\xa8 \xe2\x82\xac",
+	};
+	const char *invalid[] = {
+		"\x80", "\xc3", "\xc0\xaf", "\xe0\x80\xaf", "\xed\xa0\x80",
+		"\xf4\x90\x80\x80", "\xf8\x88\x80\x80\x80", "\xe2\x82",
+		"\xf0\x9f\x98", "\xc3\xa8\xa8", "\xff",
+	};
+
+	/* move samples across block boundaries */
+	for (size_t pad = 0; pad < 70; pad++) {
+		for (size_t i = 0; i < sizeof(valid) / sizeof(valid[0]); i++) {
+			str_t str = str_new_len(pad);
+			memset(str, 'a', pad);
+			str = str_append(str, valid[i]);
+			assert(str_utf8_valid(str));
+			str_free(str);
+		}
+
+		for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+			str_t str = str_new_len(pad);
+			memset(str, 'a', pad);
+			str = str_append(str, invalid[i]);
+			assert(!str_utf8_valid(str));
+			str = str_append(str, "tail");
+			assert(!str_utf8_valid(str));
+			str_free(str);
+		}
+	}
+}
+
+static void test_str_utf8_valid_cache(void)
+{
+	str_t str = str_new("caf\xc3\xa8");
+
+	assert(str_utf8_valid(str));
+	assert(str_utf8_valid(str));
+
+	str = str_append(str, "\xc3");
+	assert(!str_utf8_valid(str));
+
+	str = str_append(str, "\xa8");
+	assert(str_utf8_valid(str));
+
+	str_free(str);
+}
+
+static void test_str_utf8_length(void)
+{
+	str_t str = str_new("caf\xc3\xa8 \xe2\x82\xac \xf0\x9f\x98\x80");
+
+	assert(str_length(str) == 14);
+	assert(str_utf8_length(str) == 8);
+
+	str = str_repeat(str, 10);
+	assert(str_utf8_length(str) == 80);
+
+	str = str_clear(str);
+	assert(str_utf8_length(str) == 0);
+
+	str_free(str);
+}
+
+static void test_str_utf16(void)
+{
+	const uint16_t expected[] = {
+		'c', 'a', 'f', 0xe8, ' ', 0x20ac, ' ', 0xd83d, 0xde00,
+	};
+	str_t str = str_new("caf\xc3\xa8 \xe2\x82\xac \xf0\x9f\x98\x80");
+	vec_utf16_t utf16;
+	str_t back;
+
+	utf16 = str_to_utf16(str);
+	assert(utf16);
+	assert(vec_count(utf16) == 9);
+	assert(memcmp(utf16, expected, sizeof(expected)) == 0);
+
+	back = str_from_utf16(utf16);
+	assert(back);
+	assert(str_length(back) == str_length(str));
+	assert(strcmp(back, str) == 0);
+
+	str_free(back);
+	vec_free(utf16);
+	str_free(str);
+}
+
+static void test_str_utf32(void)
+{
+	const uint32_t expected[] = { 'a', 0xe8, 0x20ac, 0x1f600, 'z' };
+	str_t str = str_new("a\xc3\xa8\xe2\x82\xac\xf0\x9f\x98\x80z");
+	vec_utf32_t utf32;
+	str_t back;
+
+	utf32 = str_to_utf32(str);
+	assert(utf32);
+	assert(vec_count(utf32) == 5);
+	assert(memcmp(utf32, expected, sizeof(expected)) == 0);
+
+	back = str_from_utf32(utf32);
+	assert(back);
+	assert(strcmp(back, str) == 0);
+
+	str_free(back);
+	vec_free(utf32);
+	str_free(str);
+}
+
+static void test_str_utf16_long(void)
+{
+	str_t str = str_new("0123456789abcdef\xc3\xa8");
+	vec_utf16_t utf16;
+	vec_utf32_t utf32;
+	str_t back;
+
+	str = str_repeat(str, 20);
+
+	utf16 = str_to_utf16(str);
+	assert(utf16);
+	assert(vec_count(utf16) == 17 * 20);
+	assert(utf16[16] == 0xe8);
+	assert(utf16[17] == '0');
+
+	back = str_from_utf16(utf16);
+	assert(back);
+	assert(strcmp(back, str) == 0);
+	str_free(back);
+
+	utf32 = str_to_utf32(str);
+	assert(utf32);
+	assert(vec_count(utf32) == 17 * 20);
+
+	back = str_from_utf32(utf32);
+	assert(back);
+	assert(strcmp(back, str) == 0);
+	str_free(back);
+
+	vec_free(utf32);
+	vec_free(utf16);
+	str_free(str);
+}
+
+static void test_str_utf16_invalid(void)
+{
+	str_t str = str_new("bad \xc3");
+	vec_utf16_t utf16;
+	vec_utf32_t utf32;
+
+	assert(str_to_utf16(str) == NULL);
+	assert(str_to_utf32(str) == NULL);
+
+	utf16 = vec_new_len(sizeof(uint16_t), 2);
+	utf16[0] = 'a';
+	utf16[1] = 0xd800;
+	assert(str_from_utf16(utf16) == NULL);
+
+	utf32 = vec_new_len(sizeof(uint32_t), 1);
+	utf32[0] = 0x110000;
+	assert(str_from_utf32(utf32) == NULL);
+
+	vec_free(utf32);
+	vec_free(utf16);
+	str_free(str);
+}
+
+static void test_str_to_lower_upper(void)
+{
+	str_t str = str_new("Content-Type: TEXT/html; caf\xc3\x88 [@`{]");
+	str_t exp;
+
+	str = str_repeat(str, 3);
+	exp = str_new(str);
+
+	str = str_to_lower(str);
+	assert(str);
+	for (size_t i = 0; i < str_length(str); i++) {
+		char c = exp[i];
+		if (c >= 'A' && c <= 'Z')
+			c = (char)(c + 32);
+		assert(str[i] == c);
+	}
+
+	str = str_to_upper(str);
+	assert(str);
+	for (size_t i = 0; i < str_length(str); i++) {
+		char c = exp[i];
+		if (c >= 'a' && c <= 'z')
+			c = (char)(c - 32);
+		assert(str[i] == c);
+	}
+
+	str_free(exp);
+	str_free(str);
+}
+
+static void test_str_find_icase(void)
+{
+	str_t str = str_new("Hello HELLO hello hElLo");
+	vec_index_t pos;
+
+	pos = str_find_icase(str, "heLLo");
+	assert(pos);
+	assert(vec_count(pos) == 4);
+	assert(pos[0] == 0);
+	assert(pos[1] == 6);
+	assert(pos[2] == 12);
+	assert(pos[3] == 18);
+	vec_free(pos);
+
+	pos = str_find_icase(str, "x");
+	assert(pos);
+	assert(vec_count(pos) == 0);
+	vec_free(pos);
+
+	assert(str_find_icase(str, "") == NULL);
+
+	str_free(str);
+}
+
+static void test_str_startswith_endswith_icase(void)
+{
+	str_t str = str_new("Content-Length");
+
+	assert(str_startswith_icase(str, "content-"));
+	assert(str_startswith_icase(str, "CONTENT-LENGTH"));
+	assert(!str_startswith_icase(str, "content-length-"));
+	assert(!str_startswith_icase(str, "length"));
+	assert(str_endswith_icase(str, "LENGTH"));
+	assert(str_endswith_icase(str, ""));
+	assert(!str_endswith_icase(str, "content"));
+
+	str_free(str);
+}
+
+static void test_str_span_cspan(void)
+{
+	str_t str = str_new("  \t key: value");
+
+	assert(str_span(str, " \t") == 4);
+	assert(str_cspan(str, ":") == 7);
+	assert(str_cspan(str, "#") == str_length(str));
+	assert(str_span(str, "") == 0);
+
+	str = str_clear(str);
+	assert(str_span(str, " ") == 0);
+	assert(str_cspan(str, " ") == 0);
+
+	str_free(str);
+}
+
+static void test_str_span_long(void)
+{
+	str_t str = str_new("ab\xc3\xa8");
+	str_t tail = str_new("z");
+
+	str = str_repeat(str, 40);
+	str = str_append(str, tail);
+
+	assert(str_span(str, "ab\xc3\xa8") == 160);
+	assert(str_cspan(str, "z") == 160);
+	assert(str_cspan(str, "\xa8") == 3);
+	assert(str_span(str, "ba") == 2);
+
+	str_free(tail);
+	str_free(str);
+}
+
+static void test_str_trim(void)
+{
+	str_t str = str_new(" \t hello world \r\n");
+
+	str = str_trim(str);
+	assert(str);
+	assert(strcmp(str, "hello world") == 0);
+	assert(str_length(str) == 11);
+
+	str = str_trim(str);
+	assert(strcmp(str, "hello world") == 0);
+
+	str_free(str);
+
+	str = str_new("  x  ");
+	str = str_ltrim(str);
+	assert(strcmp(str, "x  ") == 0);
+	str = str_rtrim(str);
+	assert(strcmp(str, "x") == 0);
+	str_free(str);
+
+	str = str_new(" \n\t ");
+	str = str_trim(str);
+	assert(str);
+	assert(str_length(str) == 0);
+	assert(str[0] == '\0');
+	str_free(str);
+}
+
+static void test_str_split_multi_sep(void)
+{
+	str_t str = str_new("a, b;;c ,d");
+	vec_str_t tok;
+
+	str = str_repeat(str, 8);
+	tok = str_split(str, ", ;");
+	assert(tok);
+	assert(vec_count(tok) == 8 * 4 - 7);
+	assert(strcmp(tok[0], "a") == 0);
+	assert(strcmp(tok[1], "b") == 0);
+	assert(strcmp(tok[2], "c") == 0);
+	assert(strcmp(tok[3], "da") == 0);
+
+	str_list_free(tok);
+	str_free(str);
+}
+
+static void test_str_hash(void)
+{
+	str_t a = str_new("content-type");
+	str_t b = str_new("content-type");
+	str_t c = str_new("content-typf");
+
+	assert(str_hash(a) == str_hash(b));
+	assert(str_hash(a) != str_hash(c));
+	assert(str_hash(a) == str_hash(a));
+
+	for (size_t i = 0; i < 8; i++) {
+		a = str_repeat(a, 2);
+		b = str_repeat(b, 2);
+		assert(str_hash(a) == str_hash(b));
+	}
+
+	str_free(c);
+	str_free(b);
+	str_free(a);
+}
+
+static void test_str_hash_lengths(void)
+{
+	str_t str = str_empty();
+	uint64_t prev = str_hash(str);
+
+	/* every length crosses a different code path */
+	for (size_t i = 0; i < 100; i++) {
+		str = str_append(str, "x");
+		assert(str_hash(str) != prev);
+		prev = str_hash(str);
+	}
+
+	str_free(str);
+}
+
+static void test_str_hash_cache(void)
+{
+	str_t str = str_new("hello");
+	str_t other = str_new("hello world");
+	uint64_t hash = str_hash(str);
+
+	str = str_append(str, " world");
+	assert(str_hash(str) != hash);
+	assert(str_hash(str) == str_hash(other));
+
+	str = str_replace(str, "world", "there", -1);
+	assert(str_hash(str) != str_hash(other));
+
+	str = str_to_upper(str);
+	other = str_to_upper(str_replace(other, "world", "there", -1));
+	assert(str_hash(str) == str_hash(other));
+
+	str = str_clear(str);
+	other = str_clear(other);
+	assert(str_hash(str) == str_hash(other));
+
+	str_free(other);
+	str_free(str);
+}
+
+static void test_str_ref(void)
+{
+	str_t str = str_new("payload");
+	str_t shared;
+
+	assert(!str_is_shared(str));
+
+	shared = str_ref(str);
+	assert(shared == str);
+	assert(str_is_shared(str));
+
+	str_unref(shared);
+	assert(!str_is_shared(str));
+
+	str_free(str);
+}
+
+static void test_str_ref_copy_on_write(void)
+{
+	str_t str = str_new("hello");
+	str_t shared = str_ref(str);
+
+	shared = str_append(shared, " world");
+	assert(shared);
+	assert(shared != str);
+	assert(strcmp(shared, "hello world") == 0);
+	assert(strcmp(str, "hello") == 0);
+	assert(!str_is_shared(str));
+	assert(!str_is_shared(shared));
+
+	str_free(shared);
+	str_free(str);
+}
+
+static void test_str_ref_mutators(void)
+{
+	str_t str = str_new("  Hello World  ");
+	str_t copy;
+
+	copy = str_trim(str_ref(str));
+	assert(strcmp(copy, "Hello World") == 0);
+	str_free(copy);
+
+	copy = str_to_lower(str_ref(str));
+	assert(strcmp(copy, "  hello world  ") == 0);
+	str_free(copy);
+
+	copy = str_replace(str_ref(str), "World", "All", -1);
+	assert(strcmp(copy, "  Hello All  ") == 0);
+	str_free(copy);
+
+	copy = str_clear(str_ref(str));
+	assert(str_length(copy) == 0);
+	str_free(copy);
+
+	assert(strcmp(str, "  Hello World  ") == 0);
+	assert(!str_is_shared(str));
+
+	str_free(str);
+}
+
+static void test_str_slice(void)
+{
+	str_t str = str_new("GET /index.html HTTP/1.1");
+	str_slice_t slice;
+
+	slice = str_slice(str, 4, 15);
+	assert(str_is_shared(str));
+	assert(str_slice_length(&slice) == 11);
+	assert(str_slice_ptr(&slice) == str + 4);
+	assert(memcmp(str_slice_ptr(&slice), "/index.html", 11) == 0);
+	assert(strcmp(str_slice_cstr(&slice), "/index.html") == 0);
+	assert(str_slice_cstr(&slice) == str_slice_cstr(&slice));
+
+	str_slice_free(&slice);
+	assert(!str_is_shared(str));
+
+	str_free(str);
+}
+
+static void test_str_slice_tail(void)
+{
+	str_t str = str_new("key: value");
+	str_slice_t slice = str_slice(str, str_length(str), 5);
+
+	/* slices at the end of the parent never copy */
+	assert(str_slice_cstr(&slice) == str + 5);
+	assert(strcmp(str_slice_cstr(&slice), "value") == 0);
+
+	str_slice_free(&slice);
+	str_free(str);
+}
+
+static void test_str_slice_str(void)
+{
+	str_t str = str_new("hello world");
+	str_slice_t all = str_slice(str, 0, 100);
+	str_slice_t part = str_slice(str, 0, 5);
+	str_t a = str_slice_str(&all);
+	str_t b = str_slice_str(&part);
+
+	assert(a == str);
+	assert(strcmp(b, "hello") == 0);
+	assert(str_length(b) == 5);
+
+	str_free(b);
+	str_free(a);
+	str_slice_free(&part);
+	str_slice_free(&all);
+	str_free(str);
+}
+
+static void test_str_slice_outlives_parent(void)
+{
+	str_t str = str_new("hello world");
+	str_slice_t slice = str_slice(str, 6, 11);
+
+	str = str_append(str, "!");
+	assert(strcmp(str, "hello world!") == 0);
+	assert(strcmp(str_slice_cstr(&slice), "world") == 0);
+	str_free(str);
+
+	assert(strcmp(str_slice_cstr(&slice), "world") == 0);
+	str_slice_free(&slice);
+}
+
+static void test_str_apply_edits(void)
+{
+	str_t str = str_new("hello big world");
+	str_edit_t edits[] = {
+		{ .offset = 15, .delete_len = 0, .insert = "!" },
+		{ .offset = 0, .delete_len = 1, .insert = "H" },
+		{ .offset = 6, .delete_len = 4, .insert = NULL },
+		{ .offset = 15, .delete_len = 0, .insert = "?" },
+	};
+
+	str = str_apply_edits(str, edits, 4);
+	assert(str);
+	assert(strcmp(str, "Hello world!?") == 0);
+	assert(str_length(str) == 13);
+
+	str = str_apply_edits(str, edits, 0);
+	assert(strcmp(str, "Hello world!?") == 0);
+
+	str_free(str);
+}
+
+static void test_str_apply_edits_invalid(void)
+{
+	str_t str = str_new("hello");
+	str_edit_t overlap[] = {
+		{ .offset = 0, .delete_len = 3, .insert = "a" },
+		{ .offset = 2, .delete_len = 1, .insert = "b" },
+	};
+	str_edit_t outside[] = {
+		{ .offset = 4, .delete_len = 2, .insert = "a" },
+	};
+
+	assert(str_apply_edits(str, overlap, 2) == NULL);
+	assert(str_apply_edits(str, outside, 1) == NULL);
+	assert(strcmp(str, "hello") == 0);
+
+	str_free(str);
+}
+
+static void test_str_apply_edits_shared(void)
+{
+	str_t str = str_new("abc");
+	str_t shared = str_ref(str);
+	str_edit_t edit = { .offset = 1, .delete_len = 1, .insert = "B" };
+
+	shared = str_apply_edits(shared, &edit, 1);
+	assert(strcmp(shared, "aBc") == 0);
+	assert(strcmp(str, "abc") == 0);
+	assert(!str_is_shared(str));
+
+	str_free(shared);
+	str_free(str);
+}
+
+static void test_str_replace_non_overlapping(void)
+{
+	str_t str = str_new("aaaa");
+
+	str = str_replace(str, "aa", "b", -1);
+	assert(strcmp(str, "bb") == 0);
+
+	str = str_replace(str, "b", "ccc", 1);
+	assert(strcmp(str, "cccb") == 0);
+
+	str_free(str);
+}
+
+static void test_str_concat(void)
+{
+	str_t str = str_new("a");
+
+	str = str_concat(str, "b", "", "cd", "efg", NULL);
+	assert(str);
+	assert(strcmp(str, "abcdefg") == 0);
+	assert(str_length(str) == 7);
+
+	str = str_concat(str, NULL);
+	assert(strcmp(str, "abcdefg") == 0);
+
+	str_free(str);
+}
+
+static void test_str_writev(void)
+{
+	str_t str = str_empty();
+	const char *line = "key=value;other";
+	str_iovec_t pieces[] = {
+		{ .ptr = line, .len = 3 },
+		{ .ptr = ": ", .len = 2 },
+		{ .ptr = line + 4, .len = 5 },
+	};
+
+	str = str_writev(str, pieces, 3);
+	assert(str);
+	assert(strcmp(str, "key: value") == 0);
+	assert(str_length(str) == 10);
+
+	str = str_writev(str, NULL, 0);
+	assert(strcmp(str, "key: value") == 0);
+
+	str_free(str);
+}
+
+static void test_str_join(void)
+{
+	str_t str = str_new("a,b,,c");
+	vec_str_t tok = str_split(str, ",");
+	vec_str_t empty = vec_new(sizeof(str_t));
+	str_t joined;
+
+	joined = str_join(tok, " | ");
+	assert(joined);
+	assert(strcmp(joined, "a | b | c") == 0);
+	assert(str_length(joined) == 9);
+	str_free(joined);
+
+	joined = str_join(empty, ",");
+	assert(joined);
+	assert(str_length(joined) == 0);
+	str_free(joined);
+
+	vec_free(empty);
+	str_list_free(tok);
+	str_free(str);
+}
+
+static void test_str_repeat_large(void)
+{
+	str_t str = str_new("abc");
+
+	str = str_repeat(str, 100000);
+	assert(str);
+	assert(str_length(str) == 300000);
+	assert(str[300000] == '\0');
+
+	for (size_t i = 0; i < 300000; i++)
+		assert(str[i] == "abc"[i % 3]);
+
+	str_free(str);
+}
+
+static void test_str_find_parallel(void)
+{
+	const char *pats[] = { "a", "abba", "aaaaa", "babababab", "c" };
+	const size_t threads[] = { 0, 1, 2, 3, 7, 16 };
+	str_t str = str_new_len(1 << 20);
+	uint32_t seed = 1;
+
+	/* small alphabet, so matches cross every chunk boundary */
+	for (size_t i = 0; i < str_length(str); i++) {
+		seed = seed * 1103515245 + 12345;
+		str[i] = (seed >> 16) & 1 ? 'a' : 'b';
+	}
+
+	for (size_t p = 0; p < sizeof(pats) / sizeof(pats[0]); p++) {
+		vec_index_t expected = str_find(str, pats[p]);
+
+		for (size_t t = 0; t < sizeof(threads) / sizeof(threads[0]); t++) {
+			vec_index_t found = str_find_parallel(str, pats[p],
+							      threads[t]);
+
+			assert(found);
+			assert(vec_count(found) == vec_count(expected));
+			assert(!memcmp(found, expected,
+				       vec_count(found) * sizeof(size_t)));
+			vec_free(found);
+		}
+
+		vec_free(expected);
+	}
+
+	assert(!str_find_parallel(str, "", 4));
+
+	str_free(str);
+}
+
+static void test_str_find_parallel_short(void)
+{
+	str_t str = str_new("abcabcabc");
+	vec_index_t found = str_find_parallel(str, "bca", 8);
+
+	assert(found);
+	assert(vec_count(found) == 2);
+	assert(found[0] == 1 && found[1] == 4);
+
+	vec_free(found);
+	str_free(str);
+}
+
 int main(void)
 {
 	RUN_TEST(test_str_range_forward);
@@ -1010,6 +1850,46 @@ int main(void)
 	RUN_TEST(test_str_format_reused_string_with_specifiers);
 	RUN_TEST(test_str_insert_empty_into_empty);
 	RUN_TEST(test_str_split_no_leak_verify);
+	RUN_TEST(test_str_list_parse_i64);
+	RUN_TEST(test_str_list_parse_double);
+	RUN_TEST(test_str_parse_i64);
+	RUN_TEST(test_str_parse_double);
+	RUN_TEST(test_str_parse_double_long);
+	RUN_TEST(test_str_parse_empty);
+	RUN_TEST(test_str_utf8_valid);
+	RUN_TEST(test_str_utf8_valid_cache);
+	RUN_TEST(test_str_utf8_length);
+	RUN_TEST(test_str_utf16);
+	RUN_TEST(test_str_utf32);
+	RUN_TEST(test_str_utf16_long);
+	RUN_TEST(test_str_utf16_invalid);
+	RUN_TEST(test_str_to_lower_upper);
+	RUN_TEST(test_str_find_icase);
+	RUN_TEST(test_str_startswith_endswith_icase);
+	RUN_TEST(test_str_span_cspan);
+	RUN_TEST(test_str_span_long);
+	RUN_TEST(test_str_trim);
+	RUN_TEST(test_str_split_multi_sep);
+	RUN_TEST(test_str_hash);
+	RUN_TEST(test_str_hash_lengths);
+	RUN_TEST(test_str_hash_cache);
+	RUN_TEST(test_str_ref);
+	RUN_TEST(test_str_ref_copy_on_write);
+	RUN_TEST(test_str_ref_mutators);
+	RUN_TEST(test_str_slice);
+	RUN_TEST(test_str_slice_tail);
+	RUN_TEST(test_str_slice_str);
+	RUN_TEST(test_str_slice_outlives_parent);
+	RUN_TEST(test_str_apply_edits);
+	RUN_TEST(test_str_apply_edits_invalid);
+	RUN_TEST(test_str_apply_edits_shared);
+	RUN_TEST(test_str_replace_non_overlapping);
+	RUN_TEST(test_str_concat);
+	RUN_TEST(test_str_writev);
+	RUN_TEST(test_str_join);
+	RUN_TEST(test_str_repeat_large);
+	RUN_TEST(test_str_find_parallel);
+	RUN_TEST(test_str_find_parallel_short);
 
 	return 0;
 }
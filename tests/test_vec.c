@@ -7,6 +7,7 @@
 #include "utils.h"
 #include <assert.h>
 #include <stdint.h>
+#include <string.h>
 
 static void test_vec_new(void)
 {
@@ -421,6 +422,229 @@ static void test_vec_extend_zero(void)
 	vec_free(vec);
 }
 
+static void test_vec_fill(void)
+{
+	vec_t vec = vec_new_len(sizeof(uint32_t), 1000);
+	uint32_t val = 0xdeadbeef;
+	uint32_t zero = 0;
+
+	vec_fill(vec, 0, &zero, 1000);
+	vec_fill(vec, 10, &val, 500);
+
+	for (size_t i = 0; i < 1000; i++) {
+		uint32_t *item = vec_ptr_at(vec, i);
+		assert(*item == (i >= 10 && i < 510 ? val : zero));
+	}
+
+	/* copies exceeding the vector are discarded */
+	vec_fill(vec, 990, &zero, 100);
+	assert(*(uint32_t *)vec_ptr_at(vec, 999) == zero);
+	assert(vec_count(vec) == 1000);
+
+	vec_free(vec);
+}
+
+static void test_vec_fill_pattern(void)
+{
+	vec_t vec = vec_new_len(sizeof(uint16_t), 20);
+	vec_t pattern = vec_new_len(sizeof(uint16_t), 3);
+	uint16_t items[] = { 1, 2, 3 };
+
+	vec_copy(pattern, 0, items, 3);
+	vec_fill(vec, 0, &(uint16_t){ 0 }, 20);
+	vec_fill_pattern(vec, 1, pattern, 5);
+
+	for (size_t i = 0; i < 20; i++) {
+		uint16_t *item = vec_ptr_at(vec, i);
+
+		if (i >= 1 && i < 16)
+			assert(*item == items[(i - 1) % 3]);
+		else
+			assert(*item == 0);
+	}
+
+	/* truncated in the middle of a pattern copy */
+	vec_fill_pattern(vec, 15, pattern, 10);
+	assert(*(uint16_t *)vec_ptr_at(vec, 18) == 1);
+	assert(*(uint16_t *)vec_ptr_at(vec, 19) == 2);
+
+	vec_free(pattern);
+	vec_free(vec);
+}
+
+static void test_vec_push_pop(void)
+{
+	vec_t vec = vec_new(sizeof(int));
+	int item;
+	bool ret;
+
+	ret = vec_pop(vec, &item);
+	assert(!ret);
+
+	for (int i = 0; i < 1000; i++) {
+		vec = vec_push(vec, &i);
+		assert(vec);
+	}
+
+	assert(vec_count(vec) == 1000);
+	assert(vec_capacity(vec) > 1000);
+
+	for (int i = 999; i >= 0; i--) {
+		ret = vec_pop(vec, &item);
+		assert(ret);
+		assert(item == i);
+	}
+
+	assert(vec_count(vec) == 0);
+	ret = vec_pop(vec, NULL);
+	assert(!ret);
+
+	vec_free(vec);
+}
+
+static void test_vec_insert_at(void)
+{
+	vec_t vec = vec_new(sizeof(int));
+	int head[] = { 1, 2 };
+	int mid[] = { 3, 4, 5 };
+	int tail[] = { 9 };
+	int expected[] = { 1, 3, 4, 5, 2, 9 };
+	vec_t ret;
+
+	vec = vec_insert_at(vec, 0, head, 2);
+	vec = vec_insert_at(vec, 1, mid, 3);
+	vec = vec_insert_at(vec, 5, tail, 1);
+	assert(vec);
+	ret = vec_insert_at(vec, 7, tail, 1);
+	assert(!ret);
+	ret = vec_insert_at(vec, 6, NULL, 0);
+	assert(ret == vec);
+
+	assert(vec_count(vec) == 6);
+	assert(memcmp(vec, expected, sizeof(expected)) == 0);
+
+	vec_free(vec);
+}
+
+static void test_vec_erase_range(void)
+{
+	vec_t vec = vec_new(sizeof(int));
+	int expected[] = { 0, 1, 5, 6 };
+
+	for (int i = 0; i < 8; i++)
+		vec = vec_push(vec, &i);
+
+	vec_erase_range(vec, 2, 3);
+	assert(vec_count(vec) == 5);
+
+	vec_erase_range(vec, 4, 100);
+	assert(vec_count(vec) == 4);
+	assert(memcmp(vec, expected, sizeof(expected)) == 0);
+
+	vec_erase_range(vec, 4, 1);
+	assert(vec_count(vec) == 4);
+
+	vec_free(vec);
+}
+
+static void test_vec_swap_remove(void)
+{
+	vec_t vec = vec_new(sizeof(int));
+	int expected[] = { 0, 3, 2 };
+	bool ret;
+
+	for (int i = 0; i < 4; i++)
+		vec = vec_push(vec, &i);
+
+	ret = vec_swap_remove(vec, 1);
+	assert(ret);
+	assert(vec_count(vec) == 3);
+	assert(memcmp(vec, expected, sizeof(expected)) == 0);
+
+	ret = vec_swap_remove(vec, 2);
+	assert(ret);
+	assert(vec_count(vec) == 2);
+	ret = vec_swap_remove(vec, 2);
+	assert(!ret);
+
+	vec_free(vec);
+}
+
+static void test_vec_append_vec(void)
+{
+	vec_t vec = vec_new(sizeof(int));
+	vec_t other = vec_new(sizeof(int));
+	int expected[] = { 0, 1, 10, 11, 0, 1, 10, 11 };
+
+	for (int i = 0; i < 2; i++) {
+		int j = i + 10;
+
+		vec = vec_push(vec, &i);
+		other = vec_push(other, &j);
+	}
+
+	vec = vec_append_vec(vec, other);
+	vec = vec_append_vec(vec, vec);
+	assert(vec);
+	assert(vec_count(vec) == 8);
+	assert(memcmp(vec, expected, sizeof(expected)) == 0);
+
+	vec_free(other);
+	vec_free(vec);
+}
+
+static void test_vec_at_unchecked(void)
+{
+	vec_t vec = vec_new_len(sizeof(uint64_t), 100);
+
+	for (size_t i = 0; i < 100; i++)
+		*(uint64_t *)vec_at_unchecked(vec, i) = i * 3;
+
+	for (size_t i = 0; i < 100; i++) {
+		assert(vec_at_unchecked(vec, i) == vec_ptr_at(vec, i));
+		assert(*(uint64_t *)vec_at_unchecked(vec, i) == i * 3);
+	}
+
+	vec_free(vec);
+}
+
+static void test_vec_begin_end(void)
+{
+	vec_t vec = vec_new_len(sizeof(uint32_t), 10);
+	vec_t empty = vec_new(sizeof(uint32_t));
+
+	assert(vec_begin(vec) == vec);
+	assert((uint32_t *)vec_end(vec) - (uint32_t *)vec_begin(vec) == 10);
+	assert(vec_begin(empty) == vec_end(empty));
+
+	vec_free(empty);
+	vec_free(vec);
+}
+
+static void test_vec_foreach(void)
+{
+	vec_t vec = vec_new(sizeof(int));
+	vec_t empty = vec_new(sizeof(int));
+	int sum = 0;
+
+	for (int i = 1; i <= 10; i++)
+		vec = vec_push(vec, &i);
+
+	VEC_FOREACH(int, it, vec)
+		*it *= 2;
+
+	VEC_FOREACH(int, it, vec)
+		sum += *it;
+
+	assert(sum == 110);
+
+	VEC_FOREACH(int, it, empty)
+		assert(0);
+
+	vec_free(empty);
+	vec_free(vec);
+}
+
 int main(void)
 {
 	RUN_TEST(test_vec_new);
@@ -450,6 +674,16 @@ int main(void)
 	RUN_TEST(test_vec_free);
 	RUN_TEST(test_vec_copy_into_empty);
 	RUN_TEST(test_vec_extend_zero);
+	RUN_TEST(test_vec_fill);
+	RUN_TEST(test_vec_fill_pattern);
+	RUN_TEST(test_vec_push_pop);
+	RUN_TEST(test_vec_insert_at);
+	RUN_TEST(test_vec_erase_range);
+	RUN_TEST(test_vec_swap_remove);
+	RUN_TEST(test_vec_append_vec);
+	RUN_TEST(test_vec_at_unchecked);
+	RUN_TEST(test_vec_begin_end);
+	RUN_TEST(test_vec_foreach);
 
 	return 0;
 }
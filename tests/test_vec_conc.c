@@ -0,0 +1,158 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (c) 2025 Andrea Cervesato <andrea.cervesato@mailbox.org>
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "vec_conc.h"
+#include "utils.h"
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+#define THREADS 4
+#define ITEMS 20000
+
+static void test_vec_conc_new(void)
+{
+	vec_conc_t vec = vec_conc_new(sizeof(int));
+
+	assert(vec);
+	assert(vec_conc_count(vec) == 0);
+	assert(vec_conc_unit_size(vec) == sizeof(int));
+	assert(!vec_conc_ptr_at(vec, 0));
+
+	vec_conc_free(vec);
+}
+
+static void test_vec_conc_push(void)
+{
+	vec_conc_t vec = vec_conc_new(sizeof(size_t));
+	const size_t *first;
+	bool ret;
+
+	for (size_t i = 0; i < ITEMS; i++) {
+		ret = vec_conc_push(vec, &i);
+		assert(ret);
+	}
+
+	assert(vec_conc_count(vec) == ITEMS);
+	assert(!vec_conc_ptr_at(vec, ITEMS));
+
+	first = vec_conc_ptr_at(vec, 0);
+	assert(first && *first == 0);
+
+	for (size_t i = 0; i < ITEMS; i++)
+		assert(*(const size_t *)vec_conc_ptr_at(vec, i) == i);
+
+	/* items are never moved */
+	assert(first == vec_conc_ptr_at(vec, 0));
+
+	vec_conc_free(vec);
+}
+
+static void test_vec_conc_append(void)
+{
+	vec_conc_t vec = vec_conc_new(sizeof(uint32_t));
+	uint32_t *items = malloc(5000 * sizeof(uint32_t));
+	bool ret;
+
+	assert(items);
+	ret = vec_conc_reserve(vec, 10000);
+	assert(ret);
+	assert(vec_conc_count(vec) == 0);
+
+	for (uint32_t i = 0; i < 5000; i++)
+		items[i] = i;
+
+	/* appends can cross segment boundaries */
+	ret = vec_conc_append(vec, items, 5000);
+	assert(ret);
+	ret = vec_conc_append(vec, items, 5000);
+	assert(ret);
+	ret = vec_conc_append(vec, NULL, 0);
+	assert(ret);
+	assert(vec_conc_count(vec) == 10000);
+
+	for (size_t i = 0; i < 10000; i++)
+		assert(*(const uint32_t *)vec_conc_ptr_at(vec, i) == i % 5000);
+
+	free(items);
+	vec_conc_free(vec);
+}
+
+static void *push_worker(void *arg)
+{
+	vec_conc_t vec = arg;
+	static size_t next_id;
+	size_t id = __atomic_fetch_add(&next_id, 1, __ATOMIC_RELAXED) % THREADS;
+	bool ret;
+
+	for (size_t i = 0; i < ITEMS; i++) {
+		/* zero marks an incomplete item */
+		uint64_t item = (uint64_t)(id * ITEMS + i + 1);
+
+		ret = vec_conc_push(vec, &item);
+		assert(ret);
+	}
+
+	return NULL;
+}
+
+static void *read_worker(void *arg)
+{
+	vec_conc_t vec = arg;
+	size_t seen = 0;
+
+	while (seen < THREADS * ITEMS) {
+		size_t count = vec_conc_count(vec);
+
+		for (; seen < count; seen++)
+			assert(*(const uint64_t *)vec_conc_ptr_at(vec, seen));
+	}
+
+	return NULL;
+}
+
+static void test_vec_conc_threads(void)
+{
+	vec_conc_t vec = vec_conc_new(sizeof(uint64_t));
+	pthread_t threads[THREADS + 1];
+	uint8_t *found = calloc(THREADS * ITEMS, 1);
+
+	assert(found);
+
+	pthread_create(&threads[THREADS], NULL, read_worker, vec);
+
+	for (size_t i = 0; i < THREADS; i++)
+		pthread_create(&threads[i], NULL, push_worker, vec);
+
+	for (size_t i = 0; i <= THREADS; i++)
+		pthread_join(threads[i], NULL);
+
+	assert(vec_conc_count(vec) == THREADS * ITEMS);
+
+	for (size_t i = 0; i < THREADS * ITEMS; i++) {
+		uint64_t item = *(const uint64_t *)vec_conc_ptr_at(vec, i);
+
+		assert(item && item <= THREADS * ITEMS);
+		assert(!found[item - 1]);
+		found[item - 1] = 1;
+	}
+
+	free(found);
+	vec_conc_free(vec);
+}
+
+int main(void)
+{
+	RUN_TEST(test_vec_conc_new);
+	RUN_TEST(test_vec_conc_push);
+	RUN_TEST(test_vec_conc_append);
+	RUN_TEST(test_vec_conc_threads);
+
+	return 0;
+}
@@ -0,0 +1,155 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (c) 2025 Andrea Cervesato <andrea.cervesato@mailbox.org>
+ */
+
+#include "vec_deque.h"
+#include "vec.h"
+#include "utils.h"
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+static void test_vec_deque_new(void)
+{
+	vec_deque_t deque = vec_deque_new(sizeof(int));
+	bool ret;
+
+	assert(deque);
+	assert(vec_deque_count(deque) == 0);
+	assert(vec_deque_capacity(deque) == VEC_INIT_CAPACITY);
+	assert(vec_deque_unit_size(deque) == sizeof(int));
+	assert(!vec_deque_ptr_at(deque, 0));
+	ret = vec_deque_pop_back(deque, NULL);
+	assert(!ret);
+	ret = vec_deque_pop_front(deque, NULL);
+	assert(!ret);
+
+	vec_deque_free(deque);
+}
+
+static void test_vec_deque_fifo(void)
+{
+	vec_deque_t deque = vec_deque_new(sizeof(size_t));
+	size_t item;
+	bool ret;
+
+	/* head keeps moving around the buffer */
+	for (size_t i = 0; i < 10000; i++) {
+		ret = vec_deque_push_back(deque, &i);
+		assert(ret);
+
+		if (i % 3 == 2) {
+			ret = vec_deque_pop_front(deque, &item);
+			assert(ret);
+			assert(item == i / 3);
+		}
+	}
+
+	assert(vec_deque_count(deque) == 10000 - 10000 / 3);
+	assert(vec_deque_capacity(deque) == 8192);
+
+	for (size_t i = 10000 / 3; i < 10000; i++) {
+		assert(*(size_t *)vec_deque_ptr_at(deque, 0) == i);
+		ret = vec_deque_pop_front(deque, &item);
+		assert(ret);
+		assert(item == i);
+	}
+
+	assert(vec_deque_count(deque) == 0);
+
+	vec_deque_free(deque);
+}
+
+static void test_vec_deque_both_ends(void)
+{
+	vec_deque_t deque = vec_deque_new(sizeof(int));
+	int item;
+	bool ret;
+
+	for (int i = 0; i < 200; i++) {
+		ret = vec_deque_push_back(deque, &i);
+		assert(ret);
+		item = -i - 1;
+		ret = vec_deque_push_front(deque, &item);
+		assert(ret);
+	}
+
+	assert(vec_deque_count(deque) == 400);
+
+	for (size_t i = 0; i < 400; i++) {
+		int *ptr = vec_deque_ptr_at(deque, i);
+		assert(*ptr == (int)i - 200);
+	}
+
+	assert(!vec_deque_ptr_at(deque, 400));
+
+	for (int i = 199; i >= 0; i--) {
+		ret = vec_deque_pop_back(deque, &item);
+		assert(ret);
+		assert(item == i);
+		ret = vec_deque_pop_front(deque, &item);
+		assert(ret);
+		assert(item == -i - 1);
+	}
+
+	vec_deque_free(deque);
+}
+
+static void test_vec_deque_slices(void)
+{
+	vec_deque_t deque = vec_deque_new(sizeof(uint32_t));
+	uint32_t items[100];
+	size_t first_len, second_len;
+	uint32_t *first, *second;
+	bool ret;
+
+	first = vec_deque_slices(deque, &first_len, (void **)&second,
+				 &second_len);
+	assert(!first && !second);
+	assert(first_len == 0 && second_len == 0);
+
+	for (uint32_t i = 0; i < 100; i++)
+		items[i] = i;
+
+	/* wrap the items around the buffer end */
+	ret = vec_deque_push_back_n(deque, items, 100);
+	assert(ret);
+	vec_deque_drop_front(deque, 100);
+	ret = vec_deque_push_back_n(deque, items, 100);
+	assert(ret);
+
+	first = vec_deque_slices(deque, &first_len, (void **)&second,
+				 &second_len);
+	assert(first_len == VEC_INIT_CAPACITY - 100);
+	assert(first_len + second_len == 100);
+	assert(memcmp(first, items, first_len * sizeof(uint32_t)) == 0);
+	assert(memcmp(second, items + first_len,
+		      second_len * sizeof(uint32_t)) == 0);
+
+	/* growth unwraps the items */
+	ret = vec_deque_push_back_n(deque, items, 100);
+	assert(ret);
+	assert(vec_deque_capacity(deque) == 2 * VEC_INIT_CAPACITY);
+
+	first = vec_deque_slices(deque, &first_len, (void **)&second,
+				 &second_len);
+	assert(first_len == 200 && !second && !second_len);
+	assert(memcmp(first, items, 100 * sizeof(uint32_t)) == 0);
+	assert(memcmp(first + 100, items, 100 * sizeof(uint32_t)) == 0);
+
+	vec_deque_drop_front(deque, 1000);
+	assert(vec_deque_count(deque) == 0);
+
+	vec_deque_free(deque);
+}
+
+int main(void)
+{
+	RUN_TEST(test_vec_deque_new);
+	RUN_TEST(test_vec_deque_fifo);
+	RUN_TEST(test_vec_deque_both_ends);
+	RUN_TEST(test_vec_deque_slices);
+
+	return 0;
+}
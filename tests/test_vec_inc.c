@@ -0,0 +1,158 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (c) 2025 Andrea Cervesato <andrea.cervesato@mailbox.org>
+ */
+
+#include "vec_inc.h"
+#include "vec.h"
+#include "utils.h"
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+
+static void test_vec_inc_new(void)
+{
+	vec_inc_t vec = vec_inc_new(sizeof(int));
+
+	assert(vec);
+	assert(vec_inc_count(vec) == 0);
+	assert(vec_inc_capacity(vec) == VEC_INIT_CAPACITY);
+	assert(vec_inc_unit_size(vec) == sizeof(int));
+	assert(!vec_inc_migrating(vec));
+	assert(!vec_inc_ptr_at(vec, 0));
+
+	vec_inc_free(vec);
+}
+
+static void test_vec_inc_push_pop(void)
+{
+	vec_inc_t vec = vec_inc_new(sizeof(size_t));
+	size_t item;
+	bool ret;
+
+	ret = vec_inc_pop(vec, &item);
+	assert(!ret);
+
+	for (size_t i = 0; i < 100000; i++) {
+		ret = vec_inc_push(vec, &i);
+		assert(ret);
+
+		/* reads are transparent during migration */
+		assert(*(size_t *)vec_inc_ptr_at(vec, i / 2) == i / 2);
+	}
+
+	assert(vec_inc_count(vec) == 100000);
+
+	for (size_t i = 100000; i > 0; i--) {
+		ret = vec_inc_pop(vec, &item);
+		assert(ret);
+		assert(item == i - 1);
+	}
+
+	vec_inc_free(vec);
+}
+
+static void test_vec_inc_migration(void)
+{
+	/* a large unit size makes every step migrate a single item */
+	vec_inc_t vec = vec_inc_new(VEC_INC_STEP);
+	uint8_t *item = malloc(VEC_INC_STEP);
+	size_t steps = 0;
+	bool ret;
+
+	assert(item);
+
+	for (size_t i = 0; i < VEC_INIT_CAPACITY; i++) {
+		memset(item, (int)i, VEC_INC_STEP);
+		ret = vec_inc_push(vec, item);
+		assert(ret);
+	}
+
+	assert(!vec_inc_migrating(vec));
+
+	memset(item, 0xff, VEC_INC_STEP);
+	ret = vec_inc_push(vec, item);
+	assert(ret);
+	assert(vec_inc_migrating(vec));
+	assert(vec_inc_capacity(vec) == 2 * VEC_INIT_CAPACITY);
+
+	/* old and new items are both readable and writable */
+	ret = vec_inc_set(vec, VEC_INIT_CAPACITY - 1, item);
+	assert(ret);
+
+	for (size_t i = 0; i <= VEC_INIT_CAPACITY; i++) {
+		uint8_t *ptr = vec_inc_ptr_at(vec, i);
+		int val = i < VEC_INIT_CAPACITY - 1 ? (int)i : 0xff;
+
+		assert(ptr[0] == val && ptr[VEC_INC_STEP - 1] == val);
+	}
+
+	while (vec_inc_step(vec))
+		steps++;
+
+	assert(steps < VEC_INIT_CAPACITY);
+	assert(!vec_inc_migrating(vec));
+
+	for (size_t i = 0; i < VEC_INIT_CAPACITY - 1; i++)
+		assert(((uint8_t *)vec_inc_ptr_at(vec, i))[0] == i);
+
+	free(item);
+	vec_inc_free(vec);
+}
+
+static void test_vec_inc_resize(void)
+{
+	vec_inc_t vec = vec_inc_new(sizeof(int));
+	int item = 5;
+	bool ret;
+
+	/* fill more items than a single step can migrate */
+	ret = vec_inc_resize(vec, VEC_INC_STEP);
+	assert(ret);
+
+	for (size_t i = 0; i < VEC_INC_STEP; i++) {
+		ret = vec_inc_set(vec, i, &item);
+		assert(ret);
+	}
+
+	assert(!vec_inc_migrating(vec));
+	ret = vec_inc_resize(vec, VEC_INC_STEP + 1);
+	assert(ret);
+	assert(vec_inc_migrating(vec));
+
+	/* growing again completes the pending migration */
+	ret = vec_inc_resize(vec, 4 * VEC_INC_STEP);
+	assert(ret);
+	assert(vec_inc_count(vec) == 4 * VEC_INC_STEP);
+
+	for (size_t i = 0; i < 4 * VEC_INC_STEP; i++) {
+		ret = vec_inc_get(vec, i, &item);
+		assert(ret);
+		assert(item == (i < VEC_INC_STEP ? 5 : 0));
+	}
+
+	/* shrinking below the migrated items ends the migration */
+	ret = vec_inc_resize(vec, 1);
+	assert(ret);
+	assert(!vec_inc_migrating(vec));
+	ret = vec_inc_get(vec, 0, &item);
+	assert(ret);
+	assert(item == 5);
+	ret = vec_inc_get(vec, 1, &item);
+	assert(!ret);
+	ret = vec_inc_set(vec, 1, &item);
+	assert(!ret);
+
+	vec_inc_free(vec);
+}
+
+int main(void)
+{
+	RUN_TEST(test_vec_inc_new);
+	RUN_TEST(test_vec_inc_push_pop);
+	RUN_TEST(test_vec_inc_migration);
+	RUN_TEST(test_vec_inc_resize);
+
+	return 0;
+}
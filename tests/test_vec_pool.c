@@ -0,0 +1,195 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (c) 2025 Andrea Cervesato <andrea.cervesato@mailbox.org>
+ */
+
+#include "vec_pool.h"
+#include "vec.h"
+#include "str.h"
+#include "utils.h"
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+static void square(void *items, const size_t start, const size_t len,
+		   void *ctx)
+{
+	uint64_t *data = items;
+	size_t *calls = ctx;
+
+	for (size_t i = 0; i < len; i++) {
+		assert(data[i] == start + i);
+		data[i] *= data[i];
+	}
+
+	__atomic_add_fetch(calls, 1, __ATOMIC_RELAXED);
+}
+
+static void sum(const void *items, const size_t start, const size_t len,
+		void *acc, void *ctx)
+{
+	const uint64_t *data = items;
+	uint64_t *total = acc;
+
+	(void)start;
+	(void)ctx;
+
+	for (size_t i = 0; i < len; i++)
+		*total += data[i];
+}
+
+static void sum_combine(void *acc, const void *other, void *ctx)
+{
+	(void)ctx;
+
+	*(uint64_t *)acc += *(const uint64_t *)other;
+}
+
+/* concatenate the chunk positions, to check the combination order */
+static void concat(const void *items, const size_t start, const size_t len,
+		   void *acc, void *ctx)
+{
+	(void)items;
+	(void)len;
+	(void)ctx;
+
+	str_t str = str_new("");
+
+	for (size_t i = 0; i < start / 10; i++)
+		str = str_append(str, "x");
+
+	*(str_t *)acc = str;
+}
+
+static void concat_combine(void *acc, const void *other, void *ctx)
+{
+	str_t *dst = acc;
+	str_t src = *(str_t const *)other;
+
+	(void)ctx;
+
+	*dst = str_append(*dst, src);
+	*dst = str_append(*dst, ",");
+	str_free(src);
+}
+
+static vec_t iota_new(const size_t count)
+{
+	vec_t vec = vec_new_len(sizeof(uint64_t), count);
+
+	assert(vec);
+
+	for (size_t i = 0; i < count; i++)
+		((uint64_t *)vec)[i] = i;
+
+	return vec;
+}
+
+static void test_vec_pool_new(void)
+{
+	vec_pool_t pool = vec_pool_new(3);
+
+	assert(pool);
+	assert(vec_pool_threads(pool) == 3);
+
+	vec_pool_free(pool);
+
+	assert(vec_pool_default());
+	assert(vec_pool_default() == vec_pool_default());
+	assert(vec_pool_threads(vec_pool_default()) >= 1);
+}
+
+static void test_vec_pool_for(void)
+{
+	vec_pool_t pool = vec_pool_new(4);
+	vec_t vec = iota_new(100000);
+	size_t calls = 0;
+
+	vec_pool_for(pool, vec, square, &calls, 1000);
+	assert(calls == 100);
+
+	for (size_t i = 0; i < 100000; i++)
+		assert(((uint64_t *)vec)[i] == (uint64_t)i * i);
+
+	vec_free(vec);
+	vec_pool_free(pool);
+}
+
+static void test_vec_pool_for_default_grain(void)
+{
+	vec_t vec = iota_new(10000);
+	vec_t empty = vec_new(sizeof(uint64_t));
+	size_t calls = 0;
+
+	vec_parallel_for(vec, square, &calls, 0);
+	assert(calls == (10000 * sizeof(uint64_t) + VEC_POOL_GRAIN_BYTES - 1) /
+	       VEC_POOL_GRAIN_BYTES);
+	assert(((uint64_t *)vec)[9999] == 9999 * 9999);
+
+	calls = 0;
+	vec_parallel_for(empty, square, &calls, 0);
+	assert(calls == 0);
+
+	/* without a pool, the calling thread does all the work */
+	vec_pool_for(NULL, empty, square, &calls, 0);
+	assert(calls == 0);
+
+	vec_free(empty);
+	vec_free(vec);
+}
+
+static void test_vec_pool_reduce(void)
+{
+	vec_pool_t pool = vec_pool_new(4);
+	vec_t vec = iota_new(123457);
+	uint64_t total = 0;
+	bool ret;
+
+	ret = vec_pool_reduce(pool, vec, sum, sum_combine, NULL, &total,
+			      sizeof(total), 100);
+	assert(ret);
+	assert(total == (uint64_t)123456 * 123457 / 2);
+
+	total = 0;
+	ret = vec_parallel_reduce(vec, sum, sum_combine, NULL, &total,
+				  sizeof(total), 0);
+	assert(ret);
+	assert(total == (uint64_t)123456 * 123457 / 2);
+
+	total = 0;
+	ret = vec_pool_reduce(NULL, vec, sum, sum_combine, NULL, &total,
+			      sizeof(total), 7);
+	assert(ret);
+	assert(total == (uint64_t)123456 * 123457 / 2);
+
+	vec_free(vec);
+	vec_pool_free(pool);
+}
+
+static void test_vec_pool_reduce_order(void)
+{
+	vec_pool_t pool = vec_pool_new(4);
+	vec_t vec = iota_new(40);
+	str_t result = str_new("");
+	bool ret;
+
+	ret = vec_pool_reduce(pool, vec, concat, concat_combine, NULL,
+			      &result, sizeof(result), 10);
+	assert(ret);
+	assert(strcmp(result, ",x,xx,xxx,") == 0);
+
+	str_free(result);
+	vec_free(vec);
+	vec_pool_free(pool);
+}
+
+int main(void)
+{
+	RUN_TEST(test_vec_pool_new);
+	RUN_TEST(test_vec_pool_for);
+	RUN_TEST(test_vec_pool_for_default_grain);
+	RUN_TEST(test_vec_pool_reduce);
+	RUN_TEST(test_vec_pool_reduce_order);
+
+	return 0;
+}
@@ -0,0 +1,131 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (c) 2025 Andrea Cervesato <andrea.cervesato@mailbox.org>
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "vec_rcu.h"
+#include "vec.h"
+#include "utils.h"
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+
+#define THREADS 4
+#define VERSIONS 2000
+
+/* every item of a version holds the version number */
+static vec_t version_new(const size_t version)
+{
+	vec_t vec = vec_new_len(sizeof(size_t), 64);
+
+	assert(vec);
+	vec_fill(vec, 0, &version, 64);
+
+	return vec;
+}
+
+static void test_vec_rcu_publish(void)
+{
+	vec_rcu_t rcu = vec_rcu_new(version_new(1));
+	vec_rcu_reader_t reader = vec_rcu_reader_new(rcu);
+	vec_t snap;
+
+	assert(rcu && reader);
+
+	snap = vec_rcu_read_lock(reader);
+	assert(*(size_t *)vec_ptr_at(snap, 0) == 1);
+
+	/* the snapshot survives the publishing of a new version */
+	vec_rcu_publish(rcu, version_new(2));
+	assert(vec_rcu_pending(rcu) == 1);
+	assert(*(size_t *)vec_ptr_at(snap, 63) == 1);
+
+	vec_rcu_read_unlock(reader);
+
+	snap = vec_rcu_read_lock(reader);
+	assert(*(size_t *)vec_ptr_at(snap, 0) == 2);
+	vec_rcu_read_unlock(reader);
+
+	vec_rcu_publish(rcu, version_new(3));
+	assert(vec_rcu_pending(rcu) == 0);
+
+	vec_rcu_reader_free(reader);
+	vec_rcu_free(rcu);
+}
+
+static void test_vec_rcu_synchronize(void)
+{
+	vec_rcu_t rcu = vec_rcu_new(version_new(1));
+	vec_rcu_reader_t reader = vec_rcu_reader_new(rcu);
+
+	vec_rcu_read_lock(reader);
+	vec_rcu_publish(rcu, version_new(2));
+	vec_rcu_publish(rcu, version_new(3));
+	assert(vec_rcu_pending(rcu) == 2);
+
+	vec_rcu_read_unlock(reader);
+	vec_rcu_synchronize(rcu);
+	assert(vec_rcu_pending(rcu) == 0);
+
+	vec_rcu_reader_free(reader);
+	vec_rcu_free(rcu);
+}
+
+static void *read_worker(void *arg)
+{
+	vec_rcu_t rcu = arg;
+	vec_rcu_reader_t reader = vec_rcu_reader_new(rcu);
+	size_t last = 0;
+
+	assert(reader);
+
+	while (last < VERSIONS) {
+		vec_t snap = vec_rcu_read_lock(reader);
+		size_t version = *(size_t *)vec_ptr_at(snap, 0);
+
+		/* versions are never seen going backwards or half freed */
+		assert(version >= last);
+
+		VEC_FOREACH(size_t, it, snap)
+			assert(*it == version);
+
+		last = version;
+		vec_rcu_read_unlock(reader);
+	}
+
+	vec_rcu_reader_free(reader);
+
+	return NULL;
+}
+
+static void test_vec_rcu_threads(void)
+{
+	vec_rcu_t rcu = vec_rcu_new(version_new(0));
+	pthread_t threads[THREADS];
+
+	for (size_t i = 0; i < THREADS; i++)
+		pthread_create(&threads[i], NULL, read_worker, rcu);
+
+	for (size_t i = 1; i <= VERSIONS; i++)
+		vec_rcu_publish(rcu, version_new(i));
+
+	for (size_t i = 0; i < THREADS; i++)
+		pthread_join(threads[i], NULL);
+
+	vec_rcu_synchronize(rcu);
+	assert(vec_rcu_pending(rcu) == 0);
+
+	vec_rcu_free(rcu);
+}
+
+int main(void)
+{
+	RUN_TEST(test_vec_rcu_publish);
+	RUN_TEST(test_vec_rcu_synchronize);
+	RUN_TEST(test_vec_rcu_threads);
+
+	return 0;
+}
@@ -0,0 +1,310 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (c) 2025 Andrea Cervesato <andrea.cervesato@mailbox.org>
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "vec_ring.h"
+#include "utils.h"
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+
+#define THREADS 4
+#define ITEMS 50000
+
+static void test_vec_spsc_new(void)
+{
+	vec_spsc_t ring = vec_spsc_new(sizeof(int), 100);
+	int item;
+	bool ret;
+
+	assert(ring);
+	assert(vec_spsc_capacity(ring) == 128);
+	assert(vec_spsc_count(ring) == 0);
+	ret = vec_spsc_pop(ring, &item);
+	assert(!ret);
+
+	vec_spsc_free(ring);
+}
+
+static void test_vec_spsc_push_pop(void)
+{
+	vec_spsc_t ring = vec_spsc_new(sizeof(int), 4);
+	int item;
+	bool ret;
+
+	for (int i = 0; i < 4; i++) {
+		ret = vec_spsc_push(ring, &i);
+		assert(ret);
+	}
+
+	ret = vec_spsc_push(ring, &item);
+	assert(!ret);
+	assert(vec_spsc_count(ring) == 4);
+
+	/* items wrap around the ring end */
+	for (int i = 0; i < 100; i++) {
+		ret = vec_spsc_pop(ring, &item);
+		assert(ret);
+		assert(item == i);
+
+		item = i + 4;
+		ret = vec_spsc_push(ring, &item);
+		assert(ret);
+	}
+
+	vec_spsc_free(ring);
+}
+
+static void test_vec_spsc_batch(void)
+{
+	vec_spsc_t ring = vec_spsc_new(sizeof(uint16_t), 8);
+	uint16_t in[12];
+	uint16_t out[12];
+	size_t n;
+
+	for (uint16_t i = 0; i < 12; i++)
+		in[i] = i;
+
+	n = vec_spsc_push_n(ring, in, 5);
+	assert(n == 5);
+	n = vec_spsc_pop_n(ring, out, 3);
+	assert(n == 3);
+	assert(memcmp(out, in, 3 * sizeof(uint16_t)) == 0);
+
+	/* only the free slots are filled, across the ring end */
+	n = vec_spsc_push_n(ring, in + 5, 7);
+	assert(n == 6);
+	assert(vec_spsc_count(ring) == 8);
+
+	n = vec_spsc_pop_n(ring, out, 12);
+	assert(n == 8);
+	assert(memcmp(out, in + 3, 8 * sizeof(uint16_t)) == 0);
+	n = vec_spsc_pop_n(ring, out, 12);
+	assert(n == 0);
+
+	vec_spsc_free(ring);
+}
+
+static void *spsc_producer(void *arg)
+{
+	vec_spsc_t ring = arg;
+
+	for (uint32_t i = 0; i < ITEMS; ) {
+		uint32_t batch[7];
+		size_t len = 0;
+
+		while (len < 7 && i + len < ITEMS) {
+			batch[len] = i + (uint32_t)len;
+			len++;
+		}
+
+		size_t n = vec_spsc_push_n(ring, batch, len);
+
+		/* let the consumer run when the ring is full */
+		if (!n)
+			sched_yield();
+
+		i += (uint32_t)n;
+	}
+
+	return NULL;
+}
+
+static void test_vec_spsc_threads(void)
+{
+	vec_spsc_t ring = vec_spsc_new(sizeof(uint32_t), 64);
+	pthread_t thread;
+	uint32_t expected = 0;
+
+	pthread_create(&thread, NULL, spsc_producer, ring);
+
+	while (expected < ITEMS) {
+		uint32_t batch[5];
+		size_t len = vec_spsc_pop_n(ring, batch, 5);
+
+		if (!len)
+			sched_yield();
+
+		for (size_t i = 0; i < len; i++) {
+			assert(batch[i] == expected);
+			expected++;
+		}
+	}
+
+	pthread_join(thread, NULL);
+	assert(vec_spsc_count(ring) == 0);
+
+	vec_spsc_free(ring);
+}
+
+static void test_vec_mpmc_push_pop(void)
+{
+	vec_mpmc_t ring = vec_mpmc_new(3, 3);
+	uint8_t item[3];
+	bool ret;
+
+	assert(ring);
+	assert(vec_mpmc_capacity(ring) == 4);
+	ret = vec_mpmc_pop(ring, item);
+	assert(!ret);
+
+	for (uint8_t i = 0; i < 4; i++) {
+		memset(item, i, sizeof(item));
+		ret = vec_mpmc_push(ring, item);
+		assert(ret);
+	}
+
+	ret = vec_mpmc_push(ring, item);
+	assert(!ret);
+	assert(vec_mpmc_count(ring) == 4);
+
+	for (uint8_t i = 0; i < 50; i++) {
+		ret = vec_mpmc_pop(ring, item);
+		assert(ret);
+		assert(item[0] == i && item[2] == i);
+
+		memset(item, i + 4, sizeof(item));
+		ret = vec_mpmc_push(ring, item);
+		assert(ret);
+	}
+
+	vec_mpmc_free(ring);
+}
+
+static void test_vec_mpmc_batch(void)
+{
+	vec_mpmc_t ring = vec_mpmc_new(sizeof(int), 8);
+	int in[12];
+	int out[12];
+	size_t n;
+
+	for (int i = 0; i < 12; i++)
+		in[i] = i;
+
+	n = vec_mpmc_push_n(ring, in, 5);
+	assert(n == 5);
+	n = vec_mpmc_pop_n(ring, out, 3);
+	assert(n == 3);
+	assert(memcmp(out, in, 3 * sizeof(int)) == 0);
+
+	n = vec_mpmc_push_n(ring, in + 5, 7);
+	assert(n == 6);
+	assert(vec_mpmc_count(ring) == 8);
+
+	n = vec_mpmc_pop_n(ring, out, 12);
+	assert(n == 8);
+	assert(memcmp(out, in + 3, 8 * sizeof(int)) == 0);
+	n = vec_mpmc_pop_n(ring, out, 12);
+	assert(n == 0);
+
+	vec_mpmc_free(ring);
+}
+
+struct mpmc_ctx
+{
+	vec_mpmc_t ring;
+	size_t id;
+	uint8_t *found;
+};
+
+static void *mpmc_producer(void *arg)
+{
+	struct mpmc_ctx *ctx = arg;
+
+	for (size_t i = 0; i < ITEMS; ) {
+		uint64_t batch[3];
+		size_t len = 0;
+
+		while (len < 3 && i + len < ITEMS) {
+			batch[len] = ctx->id * ITEMS + i + len;
+			len++;
+		}
+
+		size_t n = vec_mpmc_push_n(ctx->ring, batch, len);
+
+		if (!n)
+			sched_yield();
+
+		i += n;
+	}
+
+	return NULL;
+}
+
+static void *mpmc_consumer(void *arg)
+{
+	struct mpmc_ctx *ctx = arg;
+	size_t done = 0;
+
+	while (done < ITEMS) {
+		uint64_t batch[4];
+		size_t len = vec_mpmc_pop_n(ctx->ring, batch, 4);
+
+		if (!len)
+			sched_yield();
+
+		for (size_t i = 0; i < len; i++) {
+			assert(batch[i] < THREADS * ITEMS);
+
+			uint8_t seen = __atomic_exchange_n(&ctx->found[batch[i]],
+							   1, __ATOMIC_RELAXED);
+			assert(!seen);
+		}
+
+		done += len;
+	}
+
+	return NULL;
+}
+
+static void test_vec_mpmc_threads(void)
+{
+	vec_mpmc_t ring = vec_mpmc_new(sizeof(uint64_t), 256);
+	uint8_t *found = calloc(THREADS * ITEMS, 1);
+	struct mpmc_ctx ctx[THREADS];
+	pthread_t producers[THREADS];
+	pthread_t consumers[THREADS];
+
+	assert(found);
+
+	for (size_t i = 0; i < THREADS; i++) {
+		ctx[i].ring = ring;
+		ctx[i].id = i;
+		ctx[i].found = found;
+
+		pthread_create(&producers[i], NULL, mpmc_producer, &ctx[i]);
+		pthread_create(&consumers[i], NULL, mpmc_consumer, &ctx[i]);
+	}
+
+	for (size_t i = 0; i < THREADS; i++) {
+		pthread_join(producers[i], NULL);
+		pthread_join(consumers[i], NULL);
+	}
+
+	for (size_t i = 0; i < THREADS * ITEMS; i++)
+		assert(found[i]);
+
+	assert(vec_mpmc_count(ring) == 0);
+
+	free(found);
+	vec_mpmc_free(ring);
+}
+
+int main(void)
+{
+	RUN_TEST(test_vec_spsc_new);
+	RUN_TEST(test_vec_spsc_push_pop);
+	RUN_TEST(test_vec_spsc_batch);
+	RUN_TEST(test_vec_spsc_threads);
+	RUN_TEST(test_vec_mpmc_push_pop);
+	RUN_TEST(test_vec_mpmc_batch);
+	RUN_TEST(test_vec_mpmc_threads);
+
+	return 0;
+}
@@ -0,0 +1,165 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (c) 2025 Andrea Cervesato <andrea.cervesato@mailbox.org>
+ */
+
+#include "vec_seg.h"
+#include "utils.h"
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+static void test_vec_seg_new(void)
+{
+	vec_seg_t vec = vec_seg_new(sizeof(int));
+
+	assert(vec);
+	assert(vec_seg_count(vec) == 0);
+	assert(vec_seg_capacity(vec) == 0);
+	assert(vec_seg_unit_size(vec) == sizeof(int));
+	assert(!vec_seg_ptr_at(vec, 0));
+
+	vec_seg_free(vec);
+}
+
+static void test_vec_seg_push_pop(void)
+{
+	vec_seg_t vec = vec_seg_new(sizeof(size_t));
+	size_t item;
+	bool ret;
+
+	ret = vec_seg_pop(vec, &item);
+	assert(!ret);
+
+	for (size_t i = 0; i < 10000; i++) {
+		ret = vec_seg_push(vec, &i);
+		assert(ret);
+	}
+
+	assert(vec_seg_count(vec) == 10000);
+
+	for (size_t i = 0; i < 10000; i++)
+		assert(*(size_t *)vec_seg_ptr_at(vec, i) == i);
+
+	for (size_t i = 10000; i > 0; i--) {
+		ret = vec_seg_pop(vec, &item);
+		assert(ret);
+		assert(item == i - 1);
+	}
+
+	assert(vec_seg_count(vec) == 0);
+
+	vec_seg_free(vec);
+}
+
+static void test_vec_seg_stable_pointers(void)
+{
+	vec_seg_t vec = vec_seg_new(sizeof(size_t));
+	size_t *ptrs[100];
+	bool ret;
+
+	for (size_t i = 0; i < 100; i++) {
+		ret = vec_seg_push(vec, &i);
+		assert(ret);
+		ptrs[i] = vec_seg_ptr_at(vec, i);
+	}
+
+	ret = vec_seg_extend(vec, 100000);
+	assert(ret);
+
+	for (size_t i = 0; i < 100; i++) {
+		assert(ptrs[i] == vec_seg_ptr_at(vec, i));
+		assert(*ptrs[i] == i);
+	}
+
+	vec_seg_free(vec);
+}
+
+static void test_vec_seg_resize(void)
+{
+	vec_seg_t vec = vec_seg_new(sizeof(int));
+	int item = 7;
+	bool ret;
+
+	ret = vec_seg_resize(vec, 200);
+	assert(ret);
+	assert(vec_seg_count(vec) == 200);
+	assert(vec_seg_capacity(vec) >= 200);
+
+	for (size_t i = 0; i < 200; i++) {
+		ret = vec_seg_set(vec, i, &item);
+		assert(ret);
+	}
+
+	/* items exposed again by a resize are zeroed */
+	ret = vec_seg_resize(vec, 10);
+	assert(ret);
+	ret = vec_seg_resize(vec, 200);
+	assert(ret);
+
+	for (size_t i = 0; i < 200; i++) {
+		ret = vec_seg_get(vec, i, &item);
+		assert(ret);
+		assert(item == (i < 10 ? 7 : 0));
+	}
+
+	ret = vec_seg_set(vec, 200, &item);
+	assert(!ret);
+	ret = vec_seg_get(vec, 200, &item);
+	assert(!ret);
+	assert(!vec_seg_ptr_at(vec, 200));
+
+	vec_seg_free(vec);
+}
+
+static void test_vec_seg_next(void)
+{
+	vec_seg_t vec = vec_seg_new(sizeof(uint32_t));
+	size_t iter = 0;
+	size_t total = 0;
+	size_t len;
+	uint32_t *seg;
+	bool ret;
+
+	for (uint32_t i = 0; i < 1000; i++) {
+		ret = vec_seg_push(vec, &i);
+		assert(ret);
+	}
+
+	while ((seg = vec_seg_next(vec, &iter, &len))) {
+		for (size_t i = 0; i < len; i++)
+			assert(seg[i] == total + i);
+
+		total += len;
+	}
+
+	assert(total == 1000);
+
+	vec_seg_free(vec);
+}
+
+static void test_vec_seg_overflow(void)
+{
+	vec_seg_t vec = vec_seg_new(SIZE_MAX / 2);
+	bool ret;
+
+	ret = vec_seg_resize(vec, SIZE_MAX);
+	assert(!ret);
+	ret = vec_seg_resize(vec, 1);
+	assert(!ret);
+	assert(vec_seg_count(vec) == 0);
+
+	vec_seg_free(vec);
+}
+
+int main(void)
+{
+	RUN_TEST(test_vec_seg_new);
+	RUN_TEST(test_vec_seg_push_pop);
+	RUN_TEST(test_vec_seg_stable_pointers);
+	RUN_TEST(test_vec_seg_resize);
+	RUN_TEST(test_vec_seg_next);
+	RUN_TEST(test_vec_seg_overflow);
+
+	return 0;
+}
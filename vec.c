@@ -4,36 +4,31 @@
  */
 
 #include "vec.h"
+#include "vec_priv.h"
 #include <stdint.h>
 #include <stdlib.h>
 #include <assert.h>
 #include <string.h>
 
-typedef struct
+static inline size_t vec_size(size_t unit_size, size_t capacity,
+			      size_t prefix)
 {
-	size_t unit_size;
-	size_t capacity;
-	size_t count;
-	uint8_t data[];
-} vec_obj_t;
+	if (unit_size > (SIZE_MAX - sizeof(vec_obj_t) - prefix) / capacity)
+		return 0;
 
-static inline __attribute__((pure)) vec_obj_t *vec_object(vec_t self)
-{
-	assert(self);
-	return (vec_obj_t *)((uintptr_t)self - offsetof(vec_obj_t, data));
+	return prefix + sizeof(vec_obj_t) + unit_size * capacity;
 }
 
-static inline size_t vec_size(size_t unit_size, size_t capacity)
+static inline size_t vec_prefix(const size_t flags)
 {
-	if (unit_size > SIZE_MAX / capacity)
-		return 0;
-
-	return sizeof(vec_obj_t) + unit_size * capacity;
+	return flags & VEC_FLAG_STR ? sizeof(str_meta_t) : 0;
 }
 
-vec_t vec_new_len(const size_t unit_size, const size_t count)
+vec_t vec_new_flags(const size_t unit_size, const size_t count,
+		    const size_t flags)
 {
 	size_t len = VEC_INIT_CAPACITY;
+	size_t prefix = vec_prefix(flags);
 
 	if (unit_size > SIZE_MAX / len)
 		return NULL;
@@ -45,19 +40,38 @@ vec_t vec_new_len(const size_t unit_size, const size_t count)
 		len *= 2;
 	}
 
-	vec_obj_t *obj = malloc(vec_size(unit_size, len));
-	if (!obj)
+	size_t alloc_size = vec_size(unit_size, len, prefix);
+	if (!alloc_size)
 		return NULL;
 
+	uint8_t *base = malloc(alloc_size);
+	if (!base)
+		return NULL;
+
+	vec_obj_t *obj = (vec_obj_t *)(base + prefix);
+
 	obj->count = count;
 	obj->capacity = len;
 	obj->unit_size = unit_size;
+	obj->flags = flags;
+
+	if (prefix) {
+		str_meta_t *meta = (str_meta_t *)base;
+
+		meta->hash = 0;
+		meta->refs = 1;
+	}
 
 	memset(obj->data, 0, len * unit_size);
 
 	return (vec_t )obj->data;
 }
 
+vec_t vec_new_len(const size_t unit_size, const size_t count)
+{
+	return vec_new_flags(unit_size, count, 0);
+}
+
 vec_t vec_new(const size_t unit_size)
 {
 	return vec_new_len(unit_size, 0);
@@ -66,7 +80,7 @@ vec_t vec_new(const size_t unit_size)
 void vec_free(vec_t self)
 {
 	vec_obj_t *obj = vec_object(self);
-	free(obj);
+	free(vec_base(obj));
 }
 
 vec_t vec_resize(vec_t self, const size_t count)
@@ -83,15 +97,17 @@ vec_t vec_resize(vec_t self, const size_t count)
 			new_capacity *= 2;
 		}
 
-		size_t alloc_size = vec_size(obj->unit_size, new_capacity);
-	if (!alloc_size)
-		return NULL;
+		size_t prefix = vec_prefix(vec_flags(obj));
+		size_t alloc_size = vec_size(obj->unit_size, new_capacity,
+					     prefix);
+		if (!alloc_size)
+			return NULL;
 
-	vec_obj_t *new_obj = realloc(obj, alloc_size);
-		if (!new_obj)
+		uint8_t *base = realloc(vec_base(obj), alloc_size);
+		if (!base)
 			return NULL;
 
-		obj = new_obj;
+		obj = (vec_obj_t *)(base + prefix);
 		obj->capacity = new_capacity;
 
 		memset(obj->data + (old_size * obj->unit_size),
@@ -99,6 +115,7 @@ vec_t vec_resize(vec_t self, const size_t count)
 	}
 
 	obj->count = count;
+	vec_cache_reset(obj);
 
 	return (vec_t )obj->data;
 }
@@ -157,20 +174,49 @@ void vec_copy(vec_t self, const size_t pos, const void *items, size_t len)
 	if (len > tocopy)
 		len = tocopy;
 
-	/* memory can overlap, so we move data inside a buffer before copying */
-	vec_t buff = vec_new_len(obj->unit_size, len);
-	if (!buff)
+	/* memory can overlap */
+	memmove(obj->data + pos * obj->unit_size, items, len * obj->unit_size);
+	vec_cache_reset(obj);
+}
+
+void vec_set(vec_t self, const size_t pos, const void *item)
+{
+	vec_copy(self, pos, item, 1);
+}
+
+static void vec_fill_items(vec_t self, const size_t pos, const void *items,
+			   const size_t len, const size_t n)
+{
+	vec_obj_t *obj = vec_object(self);
+	if (!len || !n || pos >= obj->count)
 		return;
 
-	memcpy(buff, items, len * obj->unit_size);
-	memcpy(vec_ptr_at(self, pos), buff, len * obj->unit_size);
+	size_t total = obj->count - pos;
+	if (n <= total / len)
+		total = n * len;
 
-	vec_free(buff);
+	size_t chunk = len < total ? len : total;
+	uint8_t *dst = obj->data + pos * obj->unit_size;
+
+	memmove(dst, items, chunk * obj->unit_size);
+	vec_fill_bytes(dst, chunk * obj->unit_size, total * obj->unit_size);
+	vec_cache_reset(obj);
 }
 
-void vec_set(vec_t self, const size_t pos, const void *item)
+void vec_fill(vec_t self, const size_t pos, const void *item, size_t n)
 {
-	vec_copy(self, pos, item, 1);
+	assert(item);
+
+	vec_fill_items(self, pos, item, 1, n);
+}
+
+void vec_fill_pattern(vec_t self, const size_t pos, const vec_t pattern,
+		      size_t n)
+{
+	assert(pattern);
+	assert(vec_unit_size(pattern) == vec_unit_size(self));
+
+	vec_fill_items(self, pos, pattern, vec_count(pattern), n);
 }
 
 void vec_get(const vec_t self, const size_t pos, void *item)
@@ -183,3 +229,129 @@ void vec_get(const vec_t self, const size_t pos, void *item)
 	if (ptr)
 		memcpy(item, ptr, obj->unit_size);
 }
+
+vec_t vec_push(vec_t self, const void *item)
+{
+	assert(item);
+
+	vec_obj_t *obj = vec_object(self);
+
+	/* fast path: there's still room inside the allocated memory */
+	if (obj->count + 1 < obj->capacity) {
+		memcpy(obj->data + obj->count * obj->unit_size, item,
+			obj->unit_size);
+		obj->count++;
+		vec_cache_reset(obj);
+
+		return self;
+	}
+
+	self = vec_extend(self, 1);
+	if (!self)
+		return NULL;
+
+	obj = vec_object(self);
+	memcpy(obj->data + (obj->count - 1) * obj->unit_size, item,
+		obj->unit_size);
+
+	return self;
+}
+
+bool vec_pop(vec_t self, void *item)
+{
+	vec_obj_t *obj = vec_object(self);
+	if (!obj->count)
+		return false;
+
+	obj->count--;
+	vec_cache_reset(obj);
+
+	if (item)
+		memcpy(item, obj->data + obj->count * obj->unit_size,
+			obj->unit_size);
+
+	return true;
+}
+
+vec_t vec_insert_at(vec_t self, const size_t pos, const void *items,
+		    const size_t len)
+{
+	size_t count = vec_count(self);
+	if (pos > count)
+		return NULL;
+
+	if (!len)
+		return self;
+
+	assert(items);
+
+	self = vec_extend(self, len);
+	if (!self)
+		return NULL;
+
+	vec_obj_t *obj = vec_object(self);
+	uint8_t *ptr = obj->data + pos * obj->unit_size;
+
+	memmove(ptr + len * obj->unit_size, ptr,
+		(count - pos) * obj->unit_size);
+	memcpy(ptr, items, len * obj->unit_size);
+
+	return self;
+}
+
+void vec_erase_range(vec_t self, const size_t pos, size_t len)
+{
+	vec_obj_t *obj = vec_object(self);
+	if (pos >= obj->count || !len)
+		return;
+
+	if (len > obj->count - pos)
+		len = obj->count - pos;
+
+	uint8_t *ptr = obj->data + pos * obj->unit_size;
+
+	memmove(ptr, ptr + len * obj->unit_size,
+		(obj->count - pos - len) * obj->unit_size);
+
+	obj->count -= len;
+	vec_cache_reset(obj);
+}
+
+bool vec_swap_remove(vec_t self, const size_t pos)
+{
+	vec_obj_t *obj = vec_object(self);
+	if (pos >= obj->count)
+		return false;
+
+	obj->count--;
+
+	if (pos != obj->count)
+		memcpy(obj->data + pos * obj->unit_size,
+			obj->data + obj->count * obj->unit_size,
+			obj->unit_size);
+
+	vec_cache_reset(obj);
+
+	return true;
+}
+
+vec_t vec_append_vec(vec_t self, const vec_t other)
+{
+	assert(other);
+	assert(vec_unit_size(other) == vec_unit_size(self));
+
+	size_t count = vec_count(self);
+	size_t len = vec_count(other);
+	bool same = self == other;
+
+	self = vec_extend(self, len);
+	if (!self)
+		return NULL;
+
+	vec_obj_t *obj = vec_object(self);
+	const uint8_t *src = same ? obj->data : (const uint8_t *)other;
+
+	memcpy(obj->data + count * obj->unit_size, src, len * obj->unit_size);
+
+	return self;
+}
@@ -7,6 +7,9 @@
 #define LIBVEST_VEC_H
 
 #include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <assert.h>
 
 /** @brief Initial vector capacity. */
 #define VEC_INIT_CAPACITY 128
@@ -20,6 +23,18 @@
  */
 typedef void* vec_t;
 
+/* Header placed in front of the vector items. It's exposed only to inline the
+ * unchecked accessors, so don't use it directly.
+ */
+struct vec_obj
+{
+	size_t unit_size;
+	size_t capacity;
+	size_t count;
+	size_t flags;
+	uint8_t data[];
+};
+
 /** @brief Create a new vector with a specific number of items.
  *
  * @param unit_size Size of a single item.
@@ -126,4 +141,163 @@ void vec_set(vec_t self, const size_t pos, const void *item);
  */
 void vec_get(const vec_t self, const size_t pos, void *item);
 
+/** @brief Fill the vector with copies of a single `item`.
+ *
+ * Write `n` copies of `item` starting from `pos`. Like `vec_copy`, items which
+ * don't fit inside the vector are discarded.
+ *
+ * @param self Vector object.
+ * @param pos Vector position.
+ * @param item Pointer to the item.
+ * @param n Number of copies.
+ */
+void vec_fill(vec_t self, const size_t pos, const void *item, size_t n);
+
+/** @brief Fill the vector with copies of a `pattern` vector.
+ *
+ * Write `n` consecutive copies of `pattern` starting from `pos`. `pattern`
+ * must have the same unit size of `self`. Like `vec_copy`, items which don't
+ * fit inside the vector are discarded.
+ *
+ * @param self Vector object.
+ * @param pos Vector position.
+ * @param pattern Vector containing the pattern.
+ * @param n Number of copies.
+ */
+void vec_fill_pattern(vec_t self, const size_t pos, const vec_t pattern,
+		      size_t n);
+
+/** @brief Append an `item` at the end of the vector.
+ *
+ * Capacity grows geometrically, so a sequence of pushes runs in amortized
+ * constant time.
+ *
+ * @param self Vector object.
+ * @param item Pointer to the item.
+ * @return Pointer to the vector, NULL on allocation failure.
+ */
+vec_t vec_push(vec_t self, const void *item);
+
+/** @brief Remove the last item of the vector.
+ *
+ * @param self Vector object.
+ * @param item If not NULL, the removed item is copied here.
+ * @return false if the vector is empty, true otherwise.
+ */
+bool vec_pop(vec_t self, void *item);
+
+/** @brief Insert `len` items at `pos`, shifting the following items.
+ *
+ * `items` must not point inside the vector itself.
+ *
+ * @param self Vector object.
+ * @param pos Vector position. It can be equal to the vector count.
+ * @param items Pointer to the items.
+ * @param len Number of items.
+ * @return Pointer to the vector, NULL if `pos` is out of bounds or on
+ *	allocation failure.
+ */
+vec_t vec_insert_at(vec_t self, const size_t pos, const void *items,
+		    const size_t len);
+
+/** @brief Remove `len` items starting from `pos`, keeping the items order.
+ *
+ * Items after the vector end are ignored.
+ *
+ * @param self Vector object.
+ * @param pos Vector position.
+ * @param len Number of items.
+ */
+void vec_erase_range(vec_t self, const size_t pos, size_t len);
+
+/** @brief Remove the item at `pos` replacing it with the last item.
+ *
+ * This is a constant time removal which doesn't keep the items order.
+ *
+ * @param self Vector object.
+ * @param pos Vector position.
+ * @return false if `pos` is out of bounds, true otherwise.
+ */
+bool vec_swap_remove(vec_t self, const size_t pos);
+
+/** @brief Append all the items of `other` at the end of the vector.
+ *
+ * `other` must have the same unit size of `self` and it can be `self`.
+ *
+ * @param self Vector object.
+ * @param other Vector to append.
+ * @return Pointer to the vector, NULL on allocation failure.
+ */
+vec_t vec_append_vec(vec_t self, const vec_t other);
+
+/** @brief Return the header of a vector.
+ *
+ * @param self Vector object.
+ * @return Pointer to the header in front of the items.
+ */
+static inline __attribute__((pure)) struct vec_obj *vec_object(vec_t self)
+{
+	assert(self);
+	return (struct vec_obj *)((uintptr_t)self -
+				  offsetof(struct vec_obj, data));
+}
+
+/** @brief Return the pointer to the item at `pos` without bounds checking.
+ *
+ * Unlike `vec_ptr_at`, `pos` is not clamped. Since this function is inlined
+ * into the caller, `pos` is checked only when the caller is compiled without
+ * `NDEBUG`.
+ *
+ * @param self Vector object.
+ * @param pos Position of the item inside vector.
+ * @return Item pointer.
+ */
+static inline void *vec_at_unchecked(vec_t self, const size_t pos)
+{
+	assert(self);
+	assert(pos < vec_object(self)->count);
+
+	return (uint8_t *)self + pos * vec_object(self)->unit_size;
+}
+
+/** @brief Return the pointer to the first item of the vector.
+ *
+ * @param self Vector object.
+ * @return Pointer to the first item.
+ */
+static inline void *vec_begin(vec_t self)
+{
+	assert(self);
+
+	return self;
+}
+
+/** @brief Return the pointer past the last item of the vector.
+ *
+ * @param self Vector object.
+ * @return Pointer past the last item.
+ */
+static inline void *vec_end(vec_t self)
+{
+	assert(self);
+
+	return (uint8_t *)self + vec_object(self)->count *
+		vec_object(self)->unit_size;
+}
+
+/** @brief Iterate over the items of a vector using raw pointers.
+ *
+ * `it` is declared as a `type *` pointer to the current item. The vector must
+ * not be resized inside the loop.
+ *
+ * @param type Type of the items.
+ * @param it Name of the iterator.
+ * @param v Vector object.
+ */
+#define VEC_FOREACH(type, it, v) \
+	for (type *it = (assert(vec_unit_size(v) == sizeof(type)), \
+			 (type *)vec_begin(v)), \
+		  *it##_end = (type *)vec_end(v); \
+	     it < it##_end; it++)
+
 #endif
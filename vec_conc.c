@@ -0,0 +1,245 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (c) 2025 Andrea Cervesato <andrea.cervesato@mailbox.org>
+ */
+
+#include "vec_conc.h"
+#include "vec_priv.h"
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include <stdint.h>
+
+/*
+ * Segments are laid out like vec_seg_t ones. Each segment holds the items
+ * followed by one byte for each slot, which is set once the slot has been
+ * written. Slots are handed out only once their segments exist. After
+ * writing its slots, a producer moves the committed count forward over the
+ * whole run of ready slots with a single update. Since a producer publishes
+ * its ready flags before reading the committed count, either it or the
+ * producer of the previous slot always sees the other one's flag, so the
+ * committed count never stops behind a complete slot.
+ */
+#define SEG_MAX (sizeof(size_t) * 8 - VEC_CONC_SHIFT)
+
+struct vec_conc_obj
+{
+	size_t unit_size;
+	uint8_t *seg[SEG_MAX];
+	uint8_t pad0[VEC_CACHE_LINE];
+	size_t reserved;	/* slots given to producers */
+	uint8_t pad1[VEC_CACHE_LINE - sizeof(size_t)];
+	size_t committed;	/* slots completely written, from the first */
+	uint8_t pad2[VEC_CACHE_LINE - sizeof(size_t)];
+};
+
+static inline size_t seg_len(const size_t k)
+{
+	return (size_t)1 << (VEC_CONC_SHIFT + k);
+}
+
+static inline uint8_t *seg_ready(const vec_conc_t self, uint8_t *seg,
+				 const size_t k)
+{
+	return seg + seg_len(k) * self->unit_size;
+}
+
+/* return segment `k`, allocating it if it's missing */
+static uint8_t *seg_get(vec_conc_t self, const size_t k)
+{
+	uint8_t *seg = __atomic_load_n(&self->seg[k], __ATOMIC_ACQUIRE);
+	if (seg)
+		return seg;
+
+	if (self->unit_size > SIZE_MAX / seg_len(k) - 1)
+		return NULL;
+
+	seg = calloc(seg_len(k), self->unit_size + 1);
+	if (!seg)
+		return NULL;
+
+	uint8_t *cur = NULL;
+
+	if (!__atomic_compare_exchange_n(&self->seg[k], &cur, seg, false,
+					 __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+		/* another producer allocated it first */
+		free(seg);
+		seg = cur;
+	}
+
+	return seg;
+}
+
+/* allocate the segments holding slots [first, first + count) */
+static bool seg_reserve(vec_conc_t self, const size_t first,
+			const size_t count)
+{
+	size_t off;
+	size_t k = vec_seg_locate(first, VEC_CONC_SHIFT, &off);
+	size_t last = vec_seg_locate(first + count - 1, VEC_CONC_SHIFT, &off);
+
+	for (; k <= last; k++) {
+		if (!seg_get(self, k))
+			return false;
+	}
+
+	return true;
+}
+
+/* return the end of the run of ready slots starting at `pos` */
+static size_t ready_run(const vec_conc_t self, size_t pos)
+{
+	for (;;) {
+		size_t off;
+		size_t k = vec_seg_locate(pos, VEC_CONC_SHIFT, &off);
+		uint8_t *seg = __atomic_load_n(&self->seg[k], __ATOMIC_ACQUIRE);
+
+		if (!seg)
+			return pos;
+
+		uint8_t *ready = seg_ready(self, seg, k);
+
+		for (; off < seg_len(k); off++, pos++) {
+			if (!__atomic_load_n(ready + off, __ATOMIC_SEQ_CST))
+				return pos;
+		}
+	}
+}
+
+static void commit(vec_conc_t self)
+{
+	size_t pos = __atomic_load_n(&self->committed, __ATOMIC_SEQ_CST);
+
+	for (;;) {
+		size_t end = ready_run(self, pos);
+
+		if (end == pos)
+			return;
+
+		/* on failure, `pos` is updated to the current count */
+		if (__atomic_compare_exchange_n(&self->committed, &pos, end,
+						false, __ATOMIC_SEQ_CST,
+						__ATOMIC_SEQ_CST))
+			pos = end;
+	}
+}
+
+vec_conc_t vec_conc_new(const size_t unit_size)
+{
+	vec_conc_t self = calloc(1, sizeof(struct vec_conc_obj));
+	if (!self)
+		return NULL;
+
+	self->unit_size = unit_size;
+
+	return self;
+}
+
+void vec_conc_free(vec_conc_t self)
+{
+	assert(self);
+
+	for (size_t k = 0; k < SEG_MAX; k++)
+		free(self->seg[k]);
+
+	free(self);
+}
+
+size_t vec_conc_unit_size(const vec_conc_t self)
+{
+	assert(self);
+	return self->unit_size;
+}
+
+size_t vec_conc_count(const vec_conc_t self)
+{
+	assert(self);
+	return __atomic_load_n(&self->committed, __ATOMIC_ACQUIRE);
+}
+
+bool vec_conc_reserve(vec_conc_t self, const size_t count)
+{
+	assert(self);
+
+	if (!count)
+		return true;
+
+	if (count > SIZE_MAX - seg_len(0))
+		return false;
+
+	return seg_reserve(self, 0, count);
+}
+
+bool vec_conc_append(vec_conc_t self, const void *items, const size_t len)
+{
+	assert(self);
+	assert(items || !len);
+
+	if (!len)
+		return true;
+
+	if (len > SIZE_MAX - seg_len(0))
+		return false;
+
+	/*
+	 * Slots are only handed out once their segments exist, so a failing
+	 * append never leaves a hole the committed count would stop at.
+	 */
+	size_t pos = __atomic_load_n(&self->reserved, __ATOMIC_RELAXED);
+
+	do {
+		if (pos > SIZE_MAX - seg_len(0) - len)
+			return false;
+
+		if (!seg_reserve(self, pos, len))
+			return false;
+	} while (!__atomic_compare_exchange_n(&self->reserved, &pos, pos + len,
+					      false, __ATOMIC_RELAXED,
+					      __ATOMIC_RELAXED));
+
+	const uint8_t *src = items;
+	size_t left = len;
+
+	while (left) {
+		size_t off;
+		size_t k = vec_seg_locate(pos, VEC_CONC_SHIFT, &off);
+		uint8_t *seg = __atomic_load_n(&self->seg[k], __ATOMIC_ACQUIRE);
+
+		size_t n = seg_len(k) - off;
+		if (n > left)
+			n = left;
+
+		memcpy(seg + off * self->unit_size, src, n * self->unit_size);
+
+		for (size_t i = 0; i < n; i++)
+			__atomic_store_n(seg_ready(self, seg, k) + off + i, 1,
+					 __ATOMIC_SEQ_CST);
+
+		src += n * self->unit_size;
+		pos += n;
+		left -= n;
+	}
+
+	commit(self);
+
+	return true;
+}
+
+bool vec_conc_push(vec_conc_t self, const void *item)
+{
+	return vec_conc_append(self, item, 1);
+}
+
+const void *vec_conc_ptr_at(const vec_conc_t self, const size_t pos)
+{
+	assert(self);
+
+	if (pos >= vec_conc_count(self))
+		return NULL;
+
+	size_t off;
+	size_t k = vec_seg_locate(pos, VEC_CONC_SHIFT, &off);
+
+	return __atomic_load_n(&self->seg[k], __ATOMIC_ACQUIRE) +
+		off * self->unit_size;
+}
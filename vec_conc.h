@@ -0,0 +1,95 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (c) 2025 Andrea Cervesato <andrea.cervesato@mailbox.org>
+ */
+
+#ifndef LIBVEST_VEC_CONC_H
+#define LIBVEST_VEC_CONC_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+/** @brief Number of items inside the first segment, as a power of two. */
+#define VEC_CONC_SHIFT 10
+
+/** @brief An abstract concurrent append-only vector.
+ *
+ * Multiple threads can append items at the same time without locks: each
+ * producer reserves its slots with an atomic increment and copies the items
+ * inside segments which are never moved. Readers only see the committed
+ * items, which are the longest sequence of completely written slots starting
+ * from the first one.
+ */
+typedef struct vec_conc_obj* vec_conc_t;
+
+/** @brief Create a new concurrent vector.
+ *
+ * @param unit_size Size of a single item.
+ * @return New concurrent vector.
+ */
+vec_conc_t vec_conc_new(const size_t unit_size);
+
+/** @brief Release the concurrent vector memory.
+ *
+ * It must be called when no other thread is using the vector.
+ */
+void vec_conc_free(vec_conc_t self);
+
+/** @brief Return the size of a single item.
+ *
+ * @param self Concurrent vector object.
+ * @return Single item size.
+ */
+size_t vec_conc_unit_size(const vec_conc_t self) __attribute__((pure));
+
+/** @brief Return the number of committed items.
+ *
+ * All items before the returned position are completely written and they
+ * can be read by any thread.
+ *
+ * @param self Concurrent vector object.
+ * @return Number of committed items.
+ */
+size_t vec_conc_count(const vec_conc_t self);
+
+/** @brief Allocate the segments needed to hold `count` items.
+ *
+ * Appends which don't exceed the reserved items never allocate memory.
+ *
+ * @param self Concurrent vector object.
+ * @param count Number of items.
+ * @return True on success. False if memory can't be allocated.
+ */
+bool vec_conc_reserve(vec_conc_t self, const size_t count);
+
+/** @brief Append `len` consecutive items at the end of the vector.
+ *
+ * It can be called by multiple threads at the same time. If memory can't be
+ * allocated, no slot is taken and the vector is left as it was.
+ *
+ * @param self Concurrent vector object.
+ * @param items Pointer to the items.
+ * @param len Number of items.
+ * @return True on success. False if memory can't be allocated.
+ */
+bool vec_conc_append(vec_conc_t self, const void *items, const size_t len);
+
+/** @brief Append an `item` at the end of the vector.
+ *
+ * @param self Concurrent vector object.
+ * @param item Pointer to the item.
+ * @return True on success. False if memory can't be allocated.
+ */
+bool vec_conc_push(vec_conc_t self, const void *item);
+
+/** @brief Return the pointer to a committed item.
+ *
+ * The pointer stays valid until the vector is freed.
+ *
+ * @param self Concurrent vector object.
+ * @param pos Position of the item.
+ * @return Item pointer or NULL if the item is not committed.
+ */
+const void *vec_conc_ptr_at(const vec_conc_t self, const size_t pos);
+
+#endif
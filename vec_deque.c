@@ -0,0 +1,230 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (c) 2025 Andrea Cervesato <andrea.cervesato@mailbox.org>
+ */
+
+#include "vec_deque.h"
+#include "vec.h"
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include <stdint.h>
+
+/*
+ * Items are stored inside a vector whose count is a power of two, starting
+ * from `head` and wrapping around the vector end.
+ */
+struct vec_deque_obj
+{
+	vec_t buf;
+	size_t head;
+	size_t count;
+};
+
+static inline size_t deque_mask(const vec_deque_t self)
+{
+	return vec_count(self->buf) - 1;
+}
+
+static inline void *deque_slot(const vec_deque_t self, const size_t pos)
+{
+	return vec_at_unchecked(self->buf, (self->head + pos) & deque_mask(self));
+}
+
+/* move the items inside a larger buffer, starting from its first slot */
+static bool deque_grow(vec_deque_t self, const size_t count)
+{
+	size_t capacity = vec_count(self->buf);
+
+	while (count > capacity) {
+		if (capacity > SIZE_MAX / 2)
+			return false;
+
+		capacity *= 2;
+	}
+
+	if (capacity == vec_count(self->buf))
+		return true;
+
+	vec_t buf = vec_new_len(vec_unit_size(self->buf), capacity);
+	if (!buf)
+		return false;
+
+	size_t first_len, second_len;
+	void *second;
+	void *first = vec_deque_slices(self, &first_len, &second, &second_len);
+
+	if (first) {
+		vec_copy(buf, 0, first, first_len);
+		vec_copy(buf, first_len, second, second_len);
+	}
+
+	vec_free(self->buf);
+	self->buf = buf;
+	self->head = 0;
+
+	return true;
+}
+
+vec_deque_t vec_deque_new(const size_t unit_size)
+{
+	vec_deque_t self = calloc(1, sizeof(struct vec_deque_obj));
+	if (!self)
+		return NULL;
+
+	/* the initial vector capacity is a power of two */
+	self->buf = vec_new_len(unit_size, VEC_INIT_CAPACITY);
+	if (!self->buf) {
+		free(self);
+		return NULL;
+	}
+
+	return self;
+}
+
+void vec_deque_free(vec_deque_t self)
+{
+	assert(self);
+
+	vec_free(self->buf);
+	free(self);
+}
+
+size_t vec_deque_unit_size(const vec_deque_t self)
+{
+	assert(self);
+	return vec_unit_size(self->buf);
+}
+
+size_t vec_deque_count(const vec_deque_t self)
+{
+	assert(self);
+	return self->count;
+}
+
+size_t vec_deque_capacity(const vec_deque_t self)
+{
+	assert(self);
+	return vec_count(self->buf);
+}
+
+bool vec_deque_push_back(vec_deque_t self, const void *item)
+{
+	return vec_deque_push_back_n(self, item, 1);
+}
+
+bool vec_deque_push_front(vec_deque_t self, const void *item)
+{
+	assert(self);
+	assert(item);
+
+	if (self->count == SIZE_MAX || !deque_grow(self, self->count + 1))
+		return false;
+
+	self->head = (self->head - 1) & deque_mask(self);
+	self->count++;
+
+	memcpy(deque_slot(self, 0), item, vec_unit_size(self->buf));
+
+	return true;
+}
+
+bool vec_deque_push_back_n(vec_deque_t self, const void *items,
+			   const size_t len)
+{
+	assert(self);
+	assert(items || !len);
+
+	if (self->count > SIZE_MAX - len ||
+	    !deque_grow(self, self->count + len))
+		return false;
+
+	size_t unit_size = vec_unit_size(self->buf);
+	size_t pos = (self->head + self->count) & deque_mask(self);
+	size_t first = vec_count(self->buf) - pos;
+
+	if (first > len)
+		first = len;
+
+	if (len) {
+		vec_copy(self->buf, pos, items, first);
+		vec_copy(self->buf, 0, (const uint8_t *)items + first * unit_size,
+			 len - first);
+	}
+
+	self->count += len;
+
+	return true;
+}
+
+bool vec_deque_pop_back(vec_deque_t self, void *item)
+{
+	assert(self);
+
+	if (!self->count)
+		return false;
+
+	self->count--;
+
+	if (item)
+		memcpy(item, deque_slot(self, self->count),
+			vec_unit_size(self->buf));
+
+	return true;
+}
+
+bool vec_deque_pop_front(vec_deque_t self, void *item)
+{
+	assert(self);
+
+	if (!self->count)
+		return false;
+
+	if (item)
+		memcpy(item, deque_slot(self, 0), vec_unit_size(self->buf));
+
+	vec_deque_drop_front(self, 1);
+
+	return true;
+}
+
+void vec_deque_drop_front(vec_deque_t self, size_t len)
+{
+	assert(self);
+
+	if (len > self->count)
+		len = self->count;
+
+	self->head = (self->head + len) & deque_mask(self);
+	self->count -= len;
+}
+
+void *vec_deque_ptr_at(const vec_deque_t self, const size_t pos)
+{
+	assert(self);
+
+	if (pos >= self->count)
+		return NULL;
+
+	return deque_slot(self, pos);
+}
+
+void *vec_deque_slices(const vec_deque_t self, size_t *first_len,
+		       void **second, size_t *second_len)
+{
+	assert(self);
+	assert(first_len);
+	assert(second);
+	assert(second_len);
+
+	size_t first = vec_count(self->buf) - self->head;
+
+	if (first > self->count)
+		first = self->count;
+
+	*first_len = first;
+	*second_len = self->count - first;
+	*second = *second_len ? self->buf : NULL;
+
+	return self->count ? vec_at_unchecked(self->buf, self->head) : NULL;
+}
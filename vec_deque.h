@@ -0,0 +1,128 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (c) 2025 Andrea Cervesato <andrea.cervesato@mailbox.org>
+ */
+
+#ifndef LIBVEST_VEC_DEQUE_H
+#define LIBVEST_VEC_DEQUE_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+/** @brief An abstract double-ended queue.
+ *
+ * Items of the same size are stored inside a circular buffer, so they can be
+ * added and removed at both ends in constant time. The items are always held
+ * by at most two contiguous slices of memory.
+ */
+typedef struct vec_deque_obj* vec_deque_t;
+
+/** @brief Create a new double-ended queue.
+ *
+ * @param unit_size Size of a single item.
+ * @return New queue.
+ */
+vec_deque_t vec_deque_new(const size_t unit_size);
+
+/** @brief Release the queue memory. */
+void vec_deque_free(vec_deque_t self);
+
+/** @brief Return the size of a single item.
+ *
+ * @param self Queue object.
+ * @return Single item size.
+ */
+size_t vec_deque_unit_size(const vec_deque_t self) __attribute__((pure));
+
+/** @brief Return the number of items inside the queue.
+ *
+ * @param self Queue object.
+ * @return Number of items.
+ */
+size_t vec_deque_count(const vec_deque_t self) __attribute__((pure));
+
+/** @brief Return the number of items the queue can hold before growing.
+ *
+ * @param self Queue object.
+ * @return Capacity of the queue.
+ */
+size_t vec_deque_capacity(const vec_deque_t self) __attribute__((pure));
+
+/** @brief Add an `item` after the last one.
+ *
+ * @param self Queue object.
+ * @param item Pointer to the item.
+ * @return True on success. False if memory can't be allocated.
+ */
+bool vec_deque_push_back(vec_deque_t self, const void *item);
+
+/** @brief Add an `item` before the first one.
+ *
+ * @param self Queue object.
+ * @param item Pointer to the item.
+ * @return True on success. False if memory can't be allocated.
+ */
+bool vec_deque_push_front(vec_deque_t self, const void *item);
+
+/** @brief Add `len` items after the last one.
+ *
+ * @param self Queue object.
+ * @param items Pointer to the items.
+ * @param len Number of items.
+ * @return True on success. False if memory can't be allocated.
+ */
+bool vec_deque_push_back_n(vec_deque_t self, const void *items,
+			   const size_t len);
+
+/** @brief Remove the last item.
+ *
+ * @param self Queue object.
+ * @param item If not NULL, the removed item is copied here.
+ * @return False if the queue is empty, true otherwise.
+ */
+bool vec_deque_pop_back(vec_deque_t self, void *item);
+
+/** @brief Remove the first item.
+ *
+ * @param self Queue object.
+ * @param item If not NULL, the removed item is copied here.
+ * @return False if the queue is empty, true otherwise.
+ */
+bool vec_deque_pop_front(vec_deque_t self, void *item);
+
+/** @brief Remove the first `len` items without copying them.
+ *
+ * It's meant to be used after processing the items returned by
+ * `vec_deque_slices()`. If `len` is bigger than the number of items, the
+ * queue is emptied.
+ *
+ * @param self Queue object.
+ * @param len Number of items.
+ */
+void vec_deque_drop_front(vec_deque_t self, size_t len);
+
+/** @brief Return the pointer to the item at `pos`, counting from the first.
+ *
+ * @param self Queue object.
+ * @param pos Position of the item.
+ * @return Item pointer or NULL if `pos` is out of bounds.
+ */
+void *vec_deque_ptr_at(const vec_deque_t self, const size_t pos)
+	__attribute__((pure));
+
+/** @brief Return the two contiguous slices holding the items.
+ *
+ * The items are the ones inside the first slice followed by the ones inside
+ * the second slice. When the items don't wrap around the buffer end, the
+ * second slice is empty.
+ *
+ * @param self Queue object.
+ * @param first_len Set to the number of items inside the first slice.
+ * @param second Set to the second slice, or NULL if it's empty.
+ * @param second_len Set to the number of items inside the second slice.
+ * @return The first slice, or NULL if the queue is empty.
+ */
+void *vec_deque_slices(const vec_deque_t self, size_t *first_len,
+		       void **second, size_t *second_len);
+
+#endif
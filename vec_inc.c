@@ -0,0 +1,246 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (c) 2025 Andrea Cervesato <andrea.cervesato@mailbox.org>
+ */
+
+#include "vec_inc.h"
+#include "vec.h"
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include <stdint.h>
+
+/*
+ * During a migration, items in [0, moved) are inside `data`, items in
+ * [moved, old_count) are still inside `old` and the remaining ones are inside
+ * `data`. The new buffer has at least twice the old capacity and every push
+ * migrates at least one item, so a migration always completes before the
+ * vector runs out of capacity again.
+ */
+struct vec_inc_obj
+{
+	size_t unit_size;
+	size_t count;
+	size_t capacity;
+	uint8_t *data;
+	uint8_t *old;		/* buffer being migrated, NULL if none */
+	size_t old_count;	/* number of items to migrate */
+	size_t moved;		/* number of items already migrated */
+	size_t step;		/* number of items migrated by each step */
+};
+
+static inline uint8_t *item_at(const vec_inc_t self, const size_t pos)
+{
+	if (self->old && pos >= self->moved && pos < self->old_count)
+		return self->old + pos * self->unit_size;
+
+	return self->data + pos * self->unit_size;
+}
+
+static void migrate(vec_inc_t self, size_t len)
+{
+	if (!self->old)
+		return;
+
+	if (len > self->old_count - self->moved)
+		len = self->old_count - self->moved;
+
+	memcpy(self->data + self->moved * self->unit_size,
+		self->old + self->moved * self->unit_size,
+		len * self->unit_size);
+
+	self->moved += len;
+
+	if (self->moved >= self->old_count) {
+		free(self->old);
+		self->old = NULL;
+		self->old_count = 0;
+		self->moved = 0;
+	}
+}
+
+vec_inc_t vec_inc_new(const size_t unit_size)
+{
+	if (unit_size > SIZE_MAX / VEC_INIT_CAPACITY)
+		return NULL;
+
+	vec_inc_t self = calloc(1, sizeof(struct vec_inc_obj));
+	if (!self)
+		return NULL;
+
+	self->data = malloc(unit_size * VEC_INIT_CAPACITY);
+	if (!self->data) {
+		free(self);
+		return NULL;
+	}
+
+	self->unit_size = unit_size;
+	self->capacity = VEC_INIT_CAPACITY;
+	self->step = unit_size && unit_size < VEC_INC_STEP ?
+		VEC_INC_STEP / unit_size : 1;
+
+	return self;
+}
+
+void vec_inc_free(vec_inc_t self)
+{
+	assert(self);
+
+	free(self->old);
+	free(self->data);
+	free(self);
+}
+
+size_t vec_inc_unit_size(const vec_inc_t self)
+{
+	assert(self);
+	return self->unit_size;
+}
+
+size_t vec_inc_count(const vec_inc_t self)
+{
+	assert(self);
+	return self->count;
+}
+
+size_t vec_inc_capacity(const vec_inc_t self)
+{
+	assert(self);
+	return self->capacity;
+}
+
+bool vec_inc_migrating(const vec_inc_t self)
+{
+	assert(self);
+	return self->old != NULL;
+}
+
+bool vec_inc_step(vec_inc_t self)
+{
+	assert(self);
+
+	migrate(self, self->step);
+
+	return self->old != NULL;
+}
+
+/* allocate a buffer for at least `count` items and start the migration */
+static bool grow(vec_inc_t self, const size_t count)
+{
+	size_t capacity = self->capacity;
+
+	while (count > capacity) {
+		if (capacity > SIZE_MAX / 2)
+			return false;
+
+		capacity *= 2;
+	}
+
+	if (self->unit_size > SIZE_MAX / capacity)
+		return false;
+
+	uint8_t *data = malloc(capacity * self->unit_size);
+	if (!data)
+		return false;
+
+	/* a migration can be left only after a large resize */
+	migrate(self, SIZE_MAX);
+
+	self->old = self->data;
+	self->old_count = self->count;
+	self->moved = 0;
+	self->data = data;
+	self->capacity = capacity;
+
+	if (!self->old_count)
+		migrate(self, 0);
+
+	return true;
+}
+
+bool vec_inc_resize(vec_inc_t self, const size_t count)
+{
+	assert(self);
+
+	if (count > self->capacity && !grow(self, count))
+		return false;
+
+	if (count > self->count) {
+		/* new items are never inside the old buffer */
+		memset(self->data + self->count * self->unit_size, 0,
+			(count - self->count) * self->unit_size);
+	} else if (self->old && count < self->old_count) {
+		self->old_count = count > self->moved ? count : self->moved;
+	}
+
+	self->count = count;
+	migrate(self, self->step);
+
+	return true;
+}
+
+void *vec_inc_ptr_at(const vec_inc_t self, const size_t pos)
+{
+	assert(self);
+
+	if (pos >= self->count)
+		return NULL;
+
+	return item_at(self, pos);
+}
+
+bool vec_inc_set(vec_inc_t self, const size_t pos, const void *item)
+{
+	assert(self);
+	assert(item);
+
+	if (pos >= self->count)
+		return false;
+
+	memcpy(item_at(self, pos), item, self->unit_size);
+
+	return true;
+}
+
+bool vec_inc_get(const vec_inc_t self, const size_t pos, void *item)
+{
+	assert(self);
+	assert(item);
+
+	if (pos >= self->count)
+		return false;
+
+	memcpy(item, item_at(self, pos), self->unit_size);
+
+	return true;
+}
+
+bool vec_inc_push(vec_inc_t self, const void *item)
+{
+	assert(self);
+	assert(item);
+
+	if (self->count >= self->capacity && !grow(self, self->count + 1))
+		return false;
+
+	memcpy(self->data + self->count * self->unit_size, item,
+		self->unit_size);
+
+	self->count++;
+	migrate(self, self->step);
+
+	return true;
+}
+
+bool vec_inc_pop(vec_inc_t self, void *item)
+{
+	assert(self);
+
+	if (!self->count)
+		return false;
+
+	if (item)
+		memcpy(item, item_at(self, self->count - 1), self->unit_size);
+
+	return vec_inc_resize(self, self->count - 1);
+}
@@ -0,0 +1,129 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (c) 2025 Andrea Cervesato <andrea.cervesato@mailbox.org>
+ */
+
+#ifndef LIBVEST_VEC_INC_H
+#define LIBVEST_VEC_INC_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+/** @brief Maximum number of bytes migrated by a single operation. */
+#define VEC_INC_STEP 65536
+
+/** @brief An abstract vector with incremental growth.
+ *
+ * When the vector runs out of capacity, a larger buffer is allocated but the
+ * items are not copied at once. Every following modification migrates at
+ * most `VEC_INC_STEP` bytes from the old buffer, so the cost of growing is
+ * spread across many operations instead of stalling a single one. Reads find
+ * the items wherever they are during the migration.
+ */
+typedef struct vec_inc_obj* vec_inc_t;
+
+/** @brief Create a new vector with incremental growth.
+ *
+ * @param unit_size Size of a single item.
+ * @return New vector.
+ */
+vec_inc_t vec_inc_new(const size_t unit_size);
+
+/** @brief Release the vector memory. */
+void vec_inc_free(vec_inc_t self);
+
+/** @brief Return the size of a single item.
+ *
+ * @param self Vector object.
+ * @return Single item size.
+ */
+size_t vec_inc_unit_size(const vec_inc_t self) __attribute__((pure));
+
+/** @brief Return the number of items inside the vector.
+ *
+ * @param self Vector object.
+ * @return Number of items.
+ */
+size_t vec_inc_count(const vec_inc_t self) __attribute__((pure));
+
+/** @brief Return the capacity of the vector.
+ *
+ * @param self Vector object.
+ * @return Capacity of the vector.
+ */
+size_t vec_inc_capacity(const vec_inc_t self) __attribute__((pure));
+
+/** @brief Check if items are still being migrated to a larger buffer.
+ *
+ * @param self Vector object.
+ * @return True if a migration is in progress.
+ */
+bool vec_inc_migrating(const vec_inc_t self) __attribute__((pure));
+
+/** @brief Migrate the next `VEC_INC_STEP` bytes, if any.
+ *
+ * It can be called when the application is idle, to complete a migration
+ * before the next modifications.
+ *
+ * @param self Vector object.
+ * @return True if the migration is still in progress.
+ */
+bool vec_inc_step(vec_inc_t self);
+
+/** @brief Resize the vector to `count` items.
+ *
+ * New items are set to zero. If the vector grows beyond its capacity while
+ * a migration is in progress, the migration is completed first.
+ *
+ * @param self Vector object.
+ * @param count New number of items.
+ * @return True on success. False if memory can't be allocated.
+ */
+bool vec_inc_resize(vec_inc_t self, const size_t count);
+
+/** @brief Return the pointer to the item at `pos`.
+ *
+ * The pointer is valid until the next modification of the vector.
+ *
+ * @param self Vector object.
+ * @param pos Position of the item.
+ * @return Item pointer or NULL if `pos` is out of bounds.
+ */
+void *vec_inc_ptr_at(const vec_inc_t self, const size_t pos)
+	__attribute__((pure));
+
+/** @brief Set the item at `pos`.
+ *
+ * @param self Vector object.
+ * @param pos Position of the item.
+ * @param item Pointer to the item.
+ * @return False if `pos` is out of bounds, true otherwise.
+ */
+bool vec_inc_set(vec_inc_t self, const size_t pos, const void *item);
+
+/** @brief Copy the item at `pos` inside `item`.
+ *
+ * @param self Vector object.
+ * @param pos Position of the item.
+ * @param item Pointer to the item.
+ * @return False if `pos` is out of bounds, true otherwise.
+ */
+bool vec_inc_get(const vec_inc_t self, const size_t pos, void *item);
+
+/** @brief Append an `item` at the end of the vector.
+ *
+ * @param self Vector object.
+ * @param item Pointer to the item.
+ * @return True on success. False if memory can't be allocated.
+ */
+bool vec_inc_push(vec_inc_t self, const void *item);
+
+/** @brief Remove the last item of the vector.
+ *
+ * @param self Vector object.
+ * @param item If not NULL, the removed item is copied here.
+ * @return False if the vector is empty, true otherwise.
+ */
+bool vec_inc_pop(vec_inc_t self, void *item);
+
+#endif
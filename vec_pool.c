@@ -0,0 +1,423 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (c) 2025 Andrea Cervesato <andrea.cervesato@mailbox.org>
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "vec_pool.h"
+#include "vec.h"
+#include "vec_priv.h"
+#include "vec_deque.h"
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <unistd.h>
+
+/*
+ * Work is described by a job and it's split in fixed chunks of `grain` items.
+ * Tasks are ranges of chunks: a task longer than one chunk is split in two,
+ * the second half is queued and the first one is executed again, so queues
+ * hold the larger ranges at their front, which is where thieves steal from.
+ */
+typedef struct job
+{
+	uint8_t *items;
+	size_t unit_size;
+	size_t count;
+	size_t grain;
+	vec_for_fn fn;
+	vec_reduce_fn reduce;
+	uint8_t *accs;		/* accumulators of the chunks */
+	size_t acc_size;
+	void *ctx;
+	size_t left;		/* chunks not processed yet */
+	pthread_mutex_t lock;
+	pthread_cond_t done;
+	bool finished;		/* set under `lock` with the last chunk */
+	uint8_t pad[sizeof(size_t) - sizeof(bool)];
+} job_t;
+
+typedef struct
+{
+	job_t *job;
+	size_t begin;
+	size_t end;
+} task_t;
+
+typedef struct worker
+{
+	pthread_mutex_t lock;
+	vec_deque_t tasks;
+	pthread_t thread;
+	vec_pool_t pool;
+	uint8_t pad[VEC_CACHE_LINE];
+} worker_t;
+
+struct vec_pool_obj
+{
+	size_t threads;
+	worker_t *workers;
+	size_t next;		/* worker receiving tasks of external threads */
+	size_t queued;		/* tasks inside the queues */
+	size_t sleepers;	/* workers waiting on `wake` */
+	pthread_mutex_t lock;
+	pthread_cond_t wake;
+	bool stop;
+	uint8_t pad[sizeof(size_t) - sizeof(bool)];
+};
+
+static pthread_once_t default_once = PTHREAD_ONCE_INIT;
+static vec_pool_t default_pool;
+
+static bool task_push(vec_pool_t self, worker_t *worker, const task_t *task)
+{
+	if (!worker) {
+		size_t i = __atomic_fetch_add(&self->next, 1, __ATOMIC_RELAXED);
+
+		worker = &self->workers[i % self->threads];
+	}
+
+	pthread_mutex_lock(&worker->lock);
+	bool ret = vec_deque_push_back(worker->tasks, task);
+	pthread_mutex_unlock(&worker->lock);
+
+	if (!ret)
+		return false;
+
+	/*
+	 * Sleepers are counted before they check `queued`, so either they see
+	 * this task or we see them and wake one up.
+	 */
+	__atomic_add_fetch(&self->queued, 1, __ATOMIC_SEQ_CST);
+
+	if (__atomic_load_n(&self->sleepers, __ATOMIC_SEQ_CST)) {
+		pthread_mutex_lock(&self->lock);
+		pthread_cond_signal(&self->wake);
+		pthread_mutex_unlock(&self->lock);
+	}
+
+	return true;
+}
+
+/* pop a task from the back of our queue or steal one from the others */
+static bool task_pop(vec_pool_t self, worker_t *worker, task_t *task)
+{
+	size_t first = worker ? (size_t)(worker - self->workers) : 0;
+
+	for (size_t i = 0; i < self->threads; i++) {
+		worker_t *cur = &self->workers[(first + i) % self->threads];
+		bool ret;
+
+		pthread_mutex_lock(&cur->lock);
+
+		if (cur == worker)
+			ret = vec_deque_pop_back(cur->tasks, task);
+		else
+			ret = vec_deque_pop_front(cur->tasks, task);
+
+		pthread_mutex_unlock(&cur->lock);
+
+		if (ret) {
+			__atomic_sub_fetch(&self->queued, 1, __ATOMIC_RELAXED);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void job_chunk(job_t *job, const size_t chunk)
+{
+	size_t start = chunk * job->grain;
+	size_t len = job->count - start;
+
+	if (len > job->grain)
+		len = job->grain;
+
+	uint8_t *items = job->items + start * job->unit_size;
+
+	if (job->reduce)
+		job->reduce(items, start, len, job->accs + chunk * job->acc_size,
+			    job->ctx);
+	else
+		job->fn(items, start, len, job->ctx);
+}
+
+static void task_run(vec_pool_t self, worker_t *worker, task_t task)
+{
+	while (task.end - task.begin > 1) {
+		task_t half = task;
+
+		half.begin = task.begin + (task.end - task.begin) / 2;
+
+		if (!task_push(self, worker, &half))
+			break;
+
+		task.end = half.begin;
+	}
+
+	for (size_t i = task.begin; i < task.end; i++)
+		job_chunk(task.job, i);
+
+	size_t n = task.end - task.begin;
+	job_t *job = task.job;
+
+	/* the job can be released as soon as `finished` is set */
+	if (__atomic_sub_fetch(&job->left, n, __ATOMIC_ACQ_REL) == 0) {
+		pthread_mutex_lock(&job->lock);
+		job->finished = true;
+		pthread_cond_broadcast(&job->done);
+		pthread_mutex_unlock(&job->lock);
+	}
+}
+
+static void *worker_main(void *arg)
+{
+	worker_t *worker = arg;
+	vec_pool_t self = worker->pool;
+	task_t task;
+
+	for (;;) {
+		if (task_pop(self, worker, &task)) {
+			task_run(self, worker, task);
+			continue;
+		}
+
+		pthread_mutex_lock(&self->lock);
+		__atomic_add_fetch(&self->sleepers, 1, __ATOMIC_SEQ_CST);
+
+		while (!self->stop &&
+		       !__atomic_load_n(&self->queued, __ATOMIC_SEQ_CST))
+			pthread_cond_wait(&self->wake, &self->lock);
+
+		__atomic_sub_fetch(&self->sleepers, 1, __ATOMIC_RELAXED);
+		bool stop = self->stop;
+
+		pthread_mutex_unlock(&self->lock);
+
+		if (stop)
+			return NULL;
+	}
+}
+
+/* run the job, helping the workers until all the chunks are processed */
+static void job_run(vec_pool_t self, job_t *job)
+{
+	size_t chunks = (job->count + job->grain - 1) / job->grain;
+	task_t task = { .job = job, .begin = 0, .end = chunks };
+
+	if (!self) {
+		for (size_t i = 0; i < chunks; i++)
+			job_chunk(job, i);
+
+		return;
+	}
+
+	job->left = chunks;
+	pthread_mutex_init(&job->lock, NULL);
+	pthread_cond_init(&job->done, NULL);
+
+	task_run(self, NULL, task);
+
+	while (__atomic_load_n(&job->left, __ATOMIC_ACQUIRE) &&
+	       task_pop(self, NULL, &task))
+		task_run(self, NULL, task);
+
+	pthread_mutex_lock(&job->lock);
+
+	while (!job->finished)
+		pthread_cond_wait(&job->done, &job->lock);
+
+	pthread_mutex_unlock(&job->lock);
+
+	pthread_cond_destroy(&job->done);
+	pthread_mutex_destroy(&job->lock);
+}
+
+static size_t job_grain(const size_t unit_size, const size_t grain)
+{
+	if (grain)
+		return grain;
+
+	if (!unit_size || unit_size >= VEC_POOL_GRAIN_BYTES)
+		return 1;
+
+	return VEC_POOL_GRAIN_BYTES / unit_size;
+}
+
+/* stop the first `running` workers and release the pool */
+static void pool_release(vec_pool_t self, const size_t running)
+{
+	pthread_mutex_lock(&self->lock);
+	self->stop = true;
+	pthread_cond_broadcast(&self->wake);
+	pthread_mutex_unlock(&self->lock);
+
+	for (size_t i = 0; i < running; i++)
+		pthread_join(self->workers[i].thread, NULL);
+
+	/* queues are visited by all the workers, until they all stop */
+	for (size_t i = 0; i < self->threads; i++) {
+		pthread_mutex_destroy(&self->workers[i].lock);
+		vec_deque_free(self->workers[i].tasks);
+	}
+
+	pthread_cond_destroy(&self->wake);
+	pthread_mutex_destroy(&self->lock);
+	free(self->workers);
+	free(self);
+}
+
+vec_pool_t vec_pool_new(size_t threads)
+{
+	if (!threads) {
+		long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+		threads = cpus > 0 ? (size_t)cpus : 1;
+	}
+
+	vec_pool_t self = calloc(1, sizeof(struct vec_pool_obj));
+	if (!self)
+		return NULL;
+
+	self->workers = calloc(threads, sizeof(worker_t));
+	if (!self->workers) {
+		free(self);
+		return NULL;
+	}
+
+	pthread_mutex_init(&self->lock, NULL);
+	pthread_cond_init(&self->wake, NULL);
+
+	/* all the queues must exist before the workers start stealing */
+	for (; self->threads < threads; self->threads++) {
+		worker_t *worker = &self->workers[self->threads];
+
+		worker->pool = self;
+		worker->tasks = vec_deque_new(sizeof(task_t));
+		if (!worker->tasks)
+			break;
+
+		pthread_mutex_init(&worker->lock, NULL);
+	}
+
+	if (self->threads < threads) {
+		pool_release(self, 0);
+		return NULL;
+	}
+
+	for (size_t i = 0; i < threads; i++) {
+		worker_t *worker = &self->workers[i];
+
+		if (pthread_create(&worker->thread, NULL, worker_main, worker)) {
+			pool_release(self, i);
+			return NULL;
+		}
+	}
+
+	return self;
+}
+
+void vec_pool_free(vec_pool_t self)
+{
+	assert(self);
+
+	pool_release(self, self->threads);
+}
+
+size_t vec_pool_threads(const vec_pool_t self)
+{
+	assert(self);
+	return self->threads;
+}
+
+static void default_init(void)
+{
+	default_pool = vec_pool_new(0);
+}
+
+vec_pool_t vec_pool_default(void)
+{
+	pthread_once(&default_once, default_init);
+
+	return default_pool;
+}
+
+void vec_pool_for(vec_pool_t self, vec_t v, vec_for_fn fn, void *ctx,
+		  size_t grain)
+{
+	assert(v);
+	assert(fn);
+
+	job_t job = {
+		.items = v,
+		.unit_size = vec_unit_size(v),
+		.count = vec_count(v),
+		.fn = fn,
+		.ctx = ctx,
+	};
+
+	if (!job.count)
+		return;
+
+	job.grain = job_grain(job.unit_size, grain);
+	job_run(self, &job);
+}
+
+bool vec_pool_reduce(vec_pool_t self, const vec_t v, vec_reduce_fn fn,
+		     vec_combine_fn combine, void *ctx, void *result,
+		     const size_t result_size, size_t grain)
+{
+	assert(v);
+	assert(fn);
+	assert(combine);
+	assert(result);
+
+	job_t job = {
+		.items = v,
+		.unit_size = vec_unit_size(v),
+		.count = vec_count(v),
+		.reduce = fn,
+		.acc_size = result_size,
+		.ctx = ctx,
+	};
+
+	if (!job.count)
+		return true;
+
+	job.grain = job_grain(job.unit_size, grain);
+
+	size_t chunks = (job.count + job.grain - 1) / job.grain;
+
+	vec_t accs = vec_new_len(result_size, chunks);
+	if (!accs)
+		return false;
+
+	vec_fill(accs, 0, result, chunks);
+
+	job.accs = accs;
+	job_run(self, &job);
+
+	for (size_t i = 0; i < chunks; i++)
+		combine(result, vec_at_unchecked(accs, i), ctx);
+
+	vec_free(accs);
+
+	return true;
+}
+
+void vec_parallel_for(vec_t v, vec_for_fn fn, void *ctx, size_t grain)
+{
+	vec_pool_for(vec_pool_default(), v, fn, ctx, grain);
+}
+
+bool vec_parallel_reduce(const vec_t v, vec_reduce_fn fn,
+			 vec_combine_fn combine, void *ctx, void *result,
+			 const size_t result_size, size_t grain)
+{
+	return vec_pool_reduce(vec_pool_default(), v, fn, combine, ctx, result,
+			       result_size, grain);
+}
@@ -0,0 +1,127 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (c) 2025 Andrea Cervesato <andrea.cervesato@mailbox.org>
+ */
+
+#ifndef LIBVEST_VEC_POOL_H
+#define LIBVEST_VEC_POOL_H
+
+#include "vec.h"
+#include <stddef.h>
+#include <stdbool.h>
+
+/** @brief Number of bytes processed by a chunk when no grain is given. */
+#define VEC_POOL_GRAIN_BYTES 16384
+
+/** @brief An abstract thread pool.
+ *
+ * Each worker thread has its own queue of ranges to process. A worker splits
+ * the ranges it executes in halves, keeping one half in its queue, and idle
+ * workers steal the largest ranges from the other queues, so the load is
+ * balanced without a central queue.
+ */
+typedef struct vec_pool_obj* vec_pool_t;
+
+/** @brief Process the `len` items of a chunk, starting from `start`.
+ *
+ * @param items Pointer to the first item of the chunk.
+ * @param start Position of the first item inside the vector.
+ * @param len Number of items inside the chunk.
+ * @param ctx User context.
+ */
+typedef void (*vec_for_fn)(void *items, const size_t start, const size_t len,
+			   void *ctx);
+
+/** @brief Accumulate the `len` items of a chunk inside `acc`.
+ *
+ * @param items Pointer to the first item of the chunk.
+ * @param start Position of the first item inside the vector.
+ * @param len Number of items inside the chunk.
+ * @param acc Accumulator of the chunk, initialized with the identity value.
+ * @param ctx User context.
+ */
+typedef void (*vec_reduce_fn)(const void *items, const size_t start,
+			      const size_t len, void *acc, void *ctx);
+
+/** @brief Combine the `other` accumulator inside `acc`.
+ *
+ * @param acc Accumulator of the previous chunks.
+ * @param other Accumulator of the following chunk.
+ * @param ctx User context.
+ */
+typedef void (*vec_combine_fn)(void *acc, const void *other, void *ctx);
+
+/** @brief Create a new thread pool.
+ *
+ * @param threads Number of worker threads. If 0, one for each online CPU.
+ * @return New thread pool.
+ */
+vec_pool_t vec_pool_new(size_t threads);
+
+/** @brief Stop the worker threads and release the pool memory.
+ *
+ * It must be called when no work is running inside the pool.
+ */
+void vec_pool_free(vec_pool_t self);
+
+/** @brief Return the number of worker threads.
+ *
+ * @param self Thread pool object.
+ * @return Number of worker threads.
+ */
+size_t vec_pool_threads(const vec_pool_t self) __attribute__((pure));
+
+/** @brief Return the default thread pool.
+ *
+ * The default pool is created on the first call, with one worker for each
+ * online CPU, and it's never released.
+ *
+ * @return The default pool or NULL if it can't be created.
+ */
+vec_pool_t vec_pool_default(void);
+
+/** @brief Call `fn` on chunks of `grain` items of the vector, in parallel.
+ *
+ * The calling thread processes chunks as well, until all of them are done.
+ * If `self` is NULL, chunks are processed by the calling thread only.
+ *
+ * @param self Thread pool object.
+ * @param v Vector object.
+ * @param fn Function processing a chunk.
+ * @param ctx User context passed to `fn`.
+ * @param grain Items inside a chunk. If 0, chunks are `VEC_POOL_GRAIN_BYTES`
+ *	long.
+ */
+void vec_pool_for(vec_pool_t self, vec_t v, vec_for_fn fn, void *ctx,
+		  size_t grain);
+
+/** @brief Reduce chunks of `grain` items of the vector, in parallel.
+ *
+ * Every chunk is accumulated by `fn` inside its own copy of `result`, then
+ * the chunk accumulators are combined inside `result` following the chunks
+ * order, so the outcome doesn't depend on the threads scheduling.
+ *
+ * @param self Thread pool object.
+ * @param v Vector object.
+ * @param fn Function accumulating a chunk.
+ * @param combine Function combining two accumulators.
+ * @param ctx User context passed to `fn` and `combine`.
+ * @param result Set to the identity value, it's set to the reduction result.
+ * @param result_size Size of the result.
+ * @param grain Items inside a chunk. If 0, chunks are `VEC_POOL_GRAIN_BYTES`
+ *	long.
+ * @return True on success. False if memory can't be allocated.
+ */
+bool vec_pool_reduce(vec_pool_t self, const vec_t v, vec_reduce_fn fn,
+		     vec_combine_fn combine, void *ctx, void *result,
+		     const size_t result_size, size_t grain);
+
+/** @brief Run `vec_pool_for()` on the default pool. */
+void vec_parallel_for(vec_t v, vec_for_fn fn, void *ctx, size_t grain);
+
+/** @brief Run `vec_pool_reduce()` on the default pool. */
+bool vec_parallel_reduce(const vec_t v, vec_reduce_fn fn,
+			 vec_combine_fn combine, void *ctx, void *result,
+			 const size_t result_size, size_t grain);
+
+#endif
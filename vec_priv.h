@@ -0,0 +1,123 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (c) 2025 Andrea Cervesato <andrea.cervesato@mailbox.org>
+ */
+
+/* Vector metadata, shared by the library sources only. */
+
+#ifndef LIBVEST_VEC_PRIV_H
+#define LIBVEST_VEC_PRIV_H
+
+#include "vec.h"
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+
+/* Cached properties of the vector content. They are reset every time the
+ * library modifies the vector, so they must be read with vec_cache_get() and
+ * stored after the cached value with vec_cache_set().
+ */
+#define VEC_CACHE_UTF8_CHECKED	(1U << 0)
+#define VEC_CACHE_UTF8_VALID	(1U << 1)
+#define VEC_CACHE_HASH		(1U << 2)
+#define VEC_CACHE_MASK		0xffU
+
+/* The vector memory is not owned by its references, so it's never released
+ * and it's always copied before being modified.
+ */
+#define VEC_FLAG_STATIC		(1U << 8)
+
+/* The vector header is preceded by a str_meta_t, see vec_new_flags(). */
+#define VEC_FLAG_STR		(1U << 9)
+
+typedef struct vec_obj vec_obj_t;
+
+/* Metadata of strings, which generic vectors don't need. */
+typedef struct
+{
+	uint64_t hash;		/* valid if VEC_CACHE_HASH is set */
+	size_t refs;
+} str_meta_t;
+
+/* Size of a cache line, used to keep data written by different threads apart
+ * and avoid false sharing.
+ */
+#define VEC_CACHE_LINE 64
+
+/* Flags are updated atomically by the cache helpers, so they must be read
+ * atomically as well.
+ */
+static inline size_t vec_flags(const vec_obj_t *obj)
+{
+	return __atomic_load_n(&obj->flags, __ATOMIC_RELAXED);
+}
+
+/* return the beginning of the vector memory, including its prefix */
+static inline void *vec_base(vec_obj_t *obj)
+{
+	if (vec_flags(obj) & VEC_FLAG_STR)
+		return (uint8_t *)obj - sizeof(str_meta_t);
+
+	return obj;
+}
+
+static inline str_meta_t *str_meta(vec_obj_t *obj)
+{
+	assert(vec_flags(obj) & VEC_FLAG_STR);
+	return (str_meta_t *)vec_base(obj);
+}
+
+static inline size_t vec_cache_get(const vec_obj_t *obj)
+{
+	return __atomic_load_n(&obj->flags, __ATOMIC_ACQUIRE) & VEC_CACHE_MASK;
+}
+
+static inline void vec_cache_set(vec_obj_t *obj, const size_t flags)
+{
+	__atomic_fetch_or(&obj->flags, flags & VEC_CACHE_MASK, __ATOMIC_RELEASE);
+}
+
+static inline void vec_cache_reset(vec_obj_t *obj)
+{
+	__atomic_fetch_and(&obj->flags, ~(size_t)VEC_CACHE_MASK,
+			   __ATOMIC_RELAXED);
+}
+
+/* Create a vector like vec_new_len(). If `flags` has VEC_FLAG_STR, the
+ * vector is preceded by a str_meta_t holding a single reference.
+ */
+vec_t vec_new_flags(const size_t unit_size, const size_t count,
+		    const size_t flags);
+
+/* Replicate the first `chunk` bytes of `dst` until `total` bytes are filled.
+ * Every pass copies what has been written so far, so only O(log(total/chunk))
+ * memcpy calls are needed. */
+static inline void vec_fill_bytes(uint8_t *dst, const size_t chunk,
+				  const size_t total)
+{
+	size_t done = chunk;
+
+	while (done < total) {
+		size_t len = done < total - done ? done : total - done;
+
+		memcpy(dst + done, dst, len);
+		done += len;
+	}
+}
+
+/* Split the position of an item inside a segmented vector, whose segment `k`
+ * holds `1 << (shift + k)` items, into the segment and the offset inside it.
+ */
+static inline size_t vec_seg_locate(const size_t pos, const size_t shift,
+				    size_t *off)
+{
+	size_t p = pos + ((size_t)1 << shift);
+	size_t bit = sizeof(unsigned long long) * 8 - 1 -
+		(size_t)__builtin_clzll((unsigned long long)p);
+
+	*off = p - ((size_t)1 << bit);
+
+	return bit - shift;
+}
+
+#endif
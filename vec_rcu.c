@@ -0,0 +1,245 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (c) 2025 Andrea Cervesato <andrea.cervesato@mailbox.org>
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "vec_rcu.h"
+#include "vec.h"
+#include "vec_priv.h"
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <sched.h>
+
+/* epoch of readers outside of a read section */
+#define EPOCH_IDLE 0
+
+/*
+ * A reader announces the current epoch before loading the published vector.
+ * A writer swaps the vector, retires the old one with the current epoch and
+ * then moves the epoch forward. Readers which announced a later epoch can
+ * only see the new vector, so a retired vector can be released when all
+ * readers are either idle or announced a later epoch.
+ *
+ * Readers only write their own cache line, so read sections don't contend
+ * with each other.
+ */
+struct vec_rcu_reader_obj
+{
+	size_t epoch;
+	vec_rcu_t rcu;
+	struct vec_rcu_reader_obj *next;
+	uint8_t pad[VEC_CACHE_LINE - 2 * sizeof(void *) - sizeof(size_t)];
+};
+
+typedef struct retired
+{
+	struct retired *next;
+	vec_t vec;
+	size_t epoch;
+} retired_t;
+
+struct vec_rcu_obj
+{
+	vec_t vec;
+	size_t epoch;
+	uint8_t pad[VEC_CACHE_LINE - sizeof(vec_t) - sizeof(size_t)];
+	pthread_mutex_t lock;		/* serializes writers and registration */
+	struct vec_rcu_reader_obj *readers;
+	retired_t *retired;
+	size_t pending;
+};
+
+/* return the oldest epoch announced by the readers */
+static size_t readers_epoch(vec_rcu_t self)
+{
+	size_t min = SIZE_MAX;
+
+	for (struct vec_rcu_reader_obj *r = self->readers; r; r = r->next) {
+		size_t epoch = __atomic_load_n(&r->epoch, __ATOMIC_SEQ_CST);
+
+		if (epoch != EPOCH_IDLE && epoch < min)
+			min = epoch;
+	}
+
+	return min;
+}
+
+/* release the retired vectors no reader can see, must hold the lock */
+static void reclaim(vec_rcu_t self)
+{
+	size_t min = readers_epoch(self);
+	retired_t **link = &self->retired;
+
+	while (*link) {
+		retired_t *cur = *link;
+
+		if (cur->epoch < min) {
+			*link = cur->next;
+			vec_free(cur->vec);
+			free(cur);
+			self->pending--;
+		} else {
+			link = &cur->next;
+		}
+	}
+}
+
+/* wait until no reader can see vectors retired up to `epoch` */
+static void wait_readers(vec_rcu_t self, const size_t epoch)
+{
+	while (readers_epoch(self) <= epoch)
+		sched_yield();
+}
+
+vec_rcu_t vec_rcu_new(vec_t vec)
+{
+	assert(vec);
+
+	vec_rcu_t self = calloc(1, sizeof(struct vec_rcu_obj));
+	if (!self)
+		return NULL;
+
+	pthread_mutex_init(&self->lock, NULL);
+	self->vec = vec;
+	self->epoch = EPOCH_IDLE + 1;
+
+	return self;
+}
+
+void vec_rcu_free(vec_rcu_t self)
+{
+	assert(self);
+	assert(!self->readers);
+
+	reclaim(self);
+	assert(!self->retired);
+
+	pthread_mutex_destroy(&self->lock);
+	vec_free(self->vec);
+	free(self);
+}
+
+vec_rcu_reader_t vec_rcu_reader_new(vec_rcu_t self)
+{
+	assert(self);
+
+	void *ptr;
+
+	if (posix_memalign(&ptr, VEC_CACHE_LINE,
+			   sizeof(struct vec_rcu_reader_obj)))
+		return NULL;
+
+	vec_rcu_reader_t reader = ptr;
+
+	reader->epoch = EPOCH_IDLE;
+	reader->rcu = self;
+
+	pthread_mutex_lock(&self->lock);
+	reader->next = self->readers;
+	self->readers = reader;
+	pthread_mutex_unlock(&self->lock);
+
+	return reader;
+}
+
+void vec_rcu_reader_free(vec_rcu_reader_t reader)
+{
+	assert(reader);
+	assert(reader->epoch == EPOCH_IDLE);
+
+	vec_rcu_t self = reader->rcu;
+
+	pthread_mutex_lock(&self->lock);
+
+	for (vec_rcu_reader_t *link = &self->readers; *link;
+	     link = &(*link)->next) {
+		if (*link == reader) {
+			*link = reader->next;
+			break;
+		}
+	}
+
+	pthread_mutex_unlock(&self->lock);
+
+	free(reader);
+}
+
+vec_t vec_rcu_read_lock(vec_rcu_reader_t reader)
+{
+	assert(reader);
+	assert(reader->epoch == EPOCH_IDLE);
+
+	vec_rcu_t self = reader->rcu;
+
+	__atomic_store_n(&reader->epoch,
+			 __atomic_load_n(&self->epoch, __ATOMIC_SEQ_CST),
+			 __ATOMIC_SEQ_CST);
+
+	return __atomic_load_n(&self->vec, __ATOMIC_SEQ_CST);
+}
+
+void vec_rcu_read_unlock(vec_rcu_reader_t reader)
+{
+	assert(reader);
+	assert(reader->epoch != EPOCH_IDLE);
+
+	__atomic_store_n(&reader->epoch, EPOCH_IDLE, __ATOMIC_RELEASE);
+}
+
+void vec_rcu_publish(vec_rcu_t self, vec_t vec)
+{
+	assert(self);
+	assert(vec);
+
+	pthread_mutex_lock(&self->lock);
+
+	vec_t old = __atomic_exchange_n(&self->vec, vec, __ATOMIC_SEQ_CST);
+	size_t epoch = __atomic_load_n(&self->epoch, __ATOMIC_RELAXED);
+	retired_t *cur = malloc(sizeof(retired_t));
+
+	__atomic_store_n(&self->epoch, epoch + 1, __ATOMIC_SEQ_CST);
+
+	if (cur) {
+		cur->vec = old;
+		cur->epoch = epoch;
+		cur->next = self->retired;
+		self->retired = cur;
+		self->pending++;
+	} else {
+		/* can't defer the release, so wait for the readers */
+		wait_readers(self, epoch);
+		vec_free(old);
+	}
+
+	reclaim(self);
+
+	pthread_mutex_unlock(&self->lock);
+}
+
+void vec_rcu_synchronize(vec_rcu_t self)
+{
+	assert(self);
+
+	pthread_mutex_lock(&self->lock);
+
+	wait_readers(self, __atomic_load_n(&self->epoch, __ATOMIC_RELAXED) - 1);
+	reclaim(self);
+
+	pthread_mutex_unlock(&self->lock);
+}
+
+size_t vec_rcu_pending(vec_rcu_t self)
+{
+	assert(self);
+
+	pthread_mutex_lock(&self->lock);
+	size_t pending = self->pending;
+	pthread_mutex_unlock(&self->lock);
+
+	return pending;
+}
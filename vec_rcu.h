@@ -0,0 +1,92 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (c) 2025 Andrea Cervesato <andrea.cervesato@mailbox.org>
+ */
+
+#ifndef LIBVEST_VEC_RCU_H
+#define LIBVEST_VEC_RCU_H
+
+#include "vec.h"
+#include <stddef.h>
+#include <stdbool.h>
+
+/** @brief A published vector for read-mostly data.
+ *
+ * Writers replace the whole vector with a new version, while readers take a
+ * snapshot of the current version without locks. A replaced version is
+ * released once no reader can be using it anymore, which is tracked by the
+ * epoch each reader entered its read section in.
+ */
+typedef struct vec_rcu_obj* vec_rcu_t;
+
+/** @brief A registered reader of a published vector.
+ *
+ * Each thread reading the vector must use its own reader.
+ */
+typedef struct vec_rcu_reader_obj* vec_rcu_reader_t;
+
+/** @brief Publish the first version of a vector.
+ *
+ * @param vec The vector, which is owned by the new object from now on.
+ * @return New published vector.
+ */
+vec_rcu_t vec_rcu_new(vec_t vec);
+
+/** @brief Release the published vector and all its old versions.
+ *
+ * All the readers must have been released before.
+ */
+void vec_rcu_free(vec_rcu_t self);
+
+/** @brief Register a new reader.
+ *
+ * @param self Published vector object.
+ * @return New reader.
+ */
+vec_rcu_reader_t vec_rcu_reader_new(vec_rcu_t self);
+
+/** @brief Unregister a reader. It must be outside of a read section. */
+void vec_rcu_reader_free(vec_rcu_reader_t reader);
+
+/** @brief Enter a read section and return the current version.
+ *
+ * The returned vector must not be modified and it stays valid until
+ * `vec_rcu_read_unlock()` is called. Read sections can't be nested.
+ *
+ * @param reader Reader object.
+ * @return Current version of the vector.
+ */
+vec_t vec_rcu_read_lock(vec_rcu_reader_t reader);
+
+/** @brief Leave the read section.
+ *
+ * @param reader Reader object.
+ */
+void vec_rcu_read_unlock(vec_rcu_reader_t reader);
+
+/** @brief Replace the current version of the vector.
+ *
+ * The previous version is released as soon as all the readers which could be
+ * using it have left their read section. Writers are serialized.
+ *
+ * @param self Published vector object.
+ * @param vec The new version, which is owned by `self` from now on.
+ */
+void vec_rcu_publish(vec_rcu_t self, vec_t vec);
+
+/** @brief Wait until all the replaced versions have been released.
+ *
+ * It must not be called inside a read section.
+ *
+ * @param self Published vector object.
+ */
+void vec_rcu_synchronize(vec_rcu_t self);
+
+/** @brief Return the number of replaced versions not released yet.
+ *
+ * @param self Published vector object.
+ * @return Number of pending versions.
+ */
+size_t vec_rcu_pending(vec_rcu_t self);
+
+#endif
@@ -0,0 +1,364 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (c) 2025 Andrea Cervesato <andrea.cervesato@mailbox.org>
+ */
+
+#include "vec_ring.h"
+#include "vec.h"
+#include "vec_priv.h"
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include <stdint.h>
+
+/*
+ * Both queues use free running head and tail counters and a power of two
+ * number of slots, so a position is mapped to its slot with a mask. Counters
+ * written by producers and consumers are kept on separate cache lines.
+ */
+struct vec_spsc_obj
+{
+	vec_t slots;
+	size_t mask;
+	uint8_t pad0[VEC_CACHE_LINE];
+	size_t tail;		/* written by the producer */
+	size_t head_cache;	/* last head seen by the producer */
+	uint8_t pad1[VEC_CACHE_LINE - 2 * sizeof(size_t)];
+	size_t head;		/* written by the consumer */
+	size_t tail_cache;	/* last tail seen by the consumer */
+	uint8_t pad2[VEC_CACHE_LINE - 2 * sizeof(size_t)];
+};
+
+/*
+ * Each slot starts with a sequence number followed by the item. A slot at
+ * position `pos` can be written when its sequence is `pos` and it can be read
+ * when its sequence is `pos + 1`. After reading it, the sequence is set to
+ * the position the slot will have in the next lap.
+ */
+struct vec_mpmc_obj
+{
+	vec_t slots;
+	size_t mask;
+	size_t unit_size;
+	uint8_t pad0[VEC_CACHE_LINE];
+	size_t tail;
+	uint8_t pad1[VEC_CACHE_LINE - sizeof(size_t)];
+	size_t head;
+	uint8_t pad2[VEC_CACHE_LINE - sizeof(size_t)];
+};
+
+static bool ring_size(size_t capacity, size_t *size)
+{
+	size_t len = 2;
+
+	while (len < capacity) {
+		if (len > SIZE_MAX / 2)
+			return false;
+
+		len *= 2;
+	}
+
+	*size = len;
+
+	return true;
+}
+
+vec_spsc_t vec_spsc_new(const size_t unit_size, const size_t capacity)
+{
+	size_t len;
+
+	if (!ring_size(capacity, &len))
+		return NULL;
+
+	vec_spsc_t self = calloc(1, sizeof(struct vec_spsc_obj));
+	if (!self)
+		return NULL;
+
+	self->slots = vec_new_len(unit_size, len);
+	if (!self->slots) {
+		free(self);
+		return NULL;
+	}
+
+	self->mask = len - 1;
+
+	return self;
+}
+
+void vec_spsc_free(vec_spsc_t self)
+{
+	assert(self);
+
+	vec_free(self->slots);
+	free(self);
+}
+
+size_t vec_spsc_capacity(const vec_spsc_t self)
+{
+	assert(self);
+	return self->mask + 1;
+}
+
+size_t vec_spsc_count(const vec_spsc_t self)
+{
+	assert(self);
+
+	size_t head = __atomic_load_n(&self->head, __ATOMIC_ACQUIRE);
+	size_t tail = __atomic_load_n(&self->tail, __ATOMIC_ACQUIRE);
+
+	return tail - head;
+}
+
+/* split `len` items from `pos` in the ones before and after the ring end */
+static inline size_t ring_first(const size_t mask, const size_t pos,
+				const size_t len)
+{
+	size_t first = mask + 1 - (pos & mask);
+
+	return first < len ? first : len;
+}
+
+static void ring_write(vec_t slots, const size_t mask, const size_t pos,
+		       const void *items, const size_t len)
+{
+	size_t unit_size = vec_unit_size(slots);
+	size_t first = ring_first(mask, pos, len);
+
+	memcpy(vec_at_unchecked(slots, pos & mask), items, first * unit_size);
+	memcpy(slots, (const uint8_t *)items + first * unit_size,
+		(len - first) * unit_size);
+}
+
+static void ring_read(const vec_t slots, const size_t mask, const size_t pos,
+		      void *items, const size_t len)
+{
+	size_t unit_size = vec_unit_size(slots);
+	size_t first = ring_first(mask, pos, len);
+
+	memcpy(items, vec_at_unchecked(slots, pos & mask), first * unit_size);
+	memcpy((uint8_t *)items + first * unit_size, slots,
+		(len - first) * unit_size);
+}
+
+size_t vec_spsc_push_n(vec_spsc_t self, const void *items, const size_t len)
+{
+	assert(self);
+	assert(items || !len);
+
+	size_t tail = __atomic_load_n(&self->tail, __ATOMIC_RELAXED);
+	size_t capacity = self->mask + 1;
+	size_t avail = capacity - (tail - self->head_cache);
+
+	if (avail < len) {
+		self->head_cache = __atomic_load_n(&self->head,
+						   __ATOMIC_ACQUIRE);
+		avail = capacity - (tail - self->head_cache);
+	}
+
+	size_t n = len < avail ? len : avail;
+	if (!n)
+		return 0;
+
+	ring_write(self->slots, self->mask, tail, items, n);
+	__atomic_store_n(&self->tail, tail + n, __ATOMIC_RELEASE);
+
+	return n;
+}
+
+size_t vec_spsc_pop_n(vec_spsc_t self, void *items, const size_t len)
+{
+	assert(self);
+	assert(items || !len);
+
+	size_t head = __atomic_load_n(&self->head, __ATOMIC_RELAXED);
+	size_t avail = self->tail_cache - head;
+
+	if (avail < len) {
+		self->tail_cache = __atomic_load_n(&self->tail,
+						   __ATOMIC_ACQUIRE);
+		avail = self->tail_cache - head;
+	}
+
+	size_t n = len < avail ? len : avail;
+	if (!n)
+		return 0;
+
+	ring_read(self->slots, self->mask, head, items, n);
+	__atomic_store_n(&self->head, head + n, __ATOMIC_RELEASE);
+
+	return n;
+}
+
+bool vec_spsc_push(vec_spsc_t self, const void *item)
+{
+	return vec_spsc_push_n(self, item, 1) == 1;
+}
+
+bool vec_spsc_pop(vec_spsc_t self, void *item)
+{
+	return vec_spsc_pop_n(self, item, 1) == 1;
+}
+
+static inline size_t *mpmc_seq(const vec_mpmc_t self, const size_t pos)
+{
+	return vec_at_unchecked(self->slots, pos & self->mask);
+}
+
+static inline uint8_t *mpmc_item(const vec_mpmc_t self, const size_t pos)
+{
+	return (uint8_t *)mpmc_seq(self, pos) + sizeof(size_t);
+}
+
+vec_mpmc_t vec_mpmc_new(const size_t unit_size, const size_t capacity)
+{
+	size_t len;
+
+	/* slots are aligned for their sequence number */
+	size_t slot_size = sizeof(size_t) + unit_size;
+	if (slot_size < unit_size || slot_size > SIZE_MAX - sizeof(size_t))
+		return NULL;
+
+	slot_size = (slot_size + sizeof(size_t) - 1) & ~(sizeof(size_t) - 1);
+
+	if (!ring_size(capacity, &len))
+		return NULL;
+
+	vec_mpmc_t self = calloc(1, sizeof(struct vec_mpmc_obj));
+	if (!self)
+		return NULL;
+
+	self->slots = vec_new_len(slot_size, len);
+	if (!self->slots) {
+		free(self);
+		return NULL;
+	}
+
+	self->mask = len - 1;
+	self->unit_size = unit_size;
+
+	for (size_t i = 0; i < len; i++)
+		*mpmc_seq(self, i) = i;
+
+	return self;
+}
+
+void vec_mpmc_free(vec_mpmc_t self)
+{
+	assert(self);
+
+	vec_free(self->slots);
+	free(self);
+}
+
+size_t vec_mpmc_capacity(const vec_mpmc_t self)
+{
+	assert(self);
+	return self->mask + 1;
+}
+
+size_t vec_mpmc_count(const vec_mpmc_t self)
+{
+	assert(self);
+
+	size_t head = __atomic_load_n(&self->head, __ATOMIC_ACQUIRE);
+	size_t tail = __atomic_load_n(&self->tail, __ATOMIC_ACQUIRE);
+
+	/* counters are read at different times */
+	if ((ptrdiff_t)(tail - head) < 0)
+		return 0;
+
+	return tail - head > self->mask + 1 ? self->mask + 1 : tail - head;
+}
+
+/*
+ * Reserve up to `len` consecutive positions from `counter`, whose slots have
+ * sequence `pos + ready`. Only the thread which moves the counter can change
+ * the sequence of those slots, so they can't be taken by anybody else after
+ * the counter has been moved.
+ */
+static size_t mpmc_reserve(vec_mpmc_t self, size_t *counter, const size_t len,
+			   const size_t ready, size_t *start)
+{
+	size_t pos = __atomic_load_n(counter, __ATOMIC_RELAXED);
+
+	for (;;) {
+		size_t n = 0;
+
+		while (n < len && n <= self->mask) {
+			size_t seq = __atomic_load_n(mpmc_seq(self, pos + n),
+						     __ATOMIC_ACQUIRE);
+			ptrdiff_t diff = (ptrdiff_t)(seq - (pos + n + ready));
+
+			if (diff)
+				break;
+
+			n++;
+		}
+
+		if (!n) {
+			size_t cur = __atomic_load_n(counter, __ATOMIC_RELAXED);
+
+			/* the queue is full or empty */
+			if (cur == pos)
+				return 0;
+
+			pos = cur;
+			continue;
+		}
+
+		if (__atomic_compare_exchange_n(counter, &pos, pos + n, true,
+						__ATOMIC_RELAXED,
+						__ATOMIC_RELAXED)) {
+			*start = pos;
+			return n;
+		}
+	}
+}
+
+size_t vec_mpmc_push_n(vec_mpmc_t self, const void *items, const size_t len)
+{
+	assert(self);
+	assert(items || !len);
+
+	size_t pos;
+	size_t n = mpmc_reserve(self, &self->tail, len, 0, &pos);
+	const uint8_t *src = items;
+
+	for (size_t i = 0; i < n; i++) {
+		memcpy(mpmc_item(self, pos + i), src + i * self->unit_size,
+			self->unit_size);
+		__atomic_store_n(mpmc_seq(self, pos + i), pos + i + 1,
+				 __ATOMIC_RELEASE);
+	}
+
+	return n;
+}
+
+size_t vec_mpmc_pop_n(vec_mpmc_t self, void *items, const size_t len)
+{
+	assert(self);
+	assert(items || !len);
+
+	size_t pos;
+	size_t n = mpmc_reserve(self, &self->head, len, 1, &pos);
+	uint8_t *dst = items;
+
+	for (size_t i = 0; i < n; i++) {
+		memcpy(dst + i * self->unit_size, mpmc_item(self, pos + i),
+			self->unit_size);
+		__atomic_store_n(mpmc_seq(self, pos + i),
+				 pos + i + self->mask + 1, __ATOMIC_RELEASE);
+	}
+
+	return n;
+}
+
+bool vec_mpmc_push(vec_mpmc_t self, const void *item)
+{
+	return vec_mpmc_push_n(self, item, 1) == 1;
+}
+
+bool vec_mpmc_pop(vec_mpmc_t self, void *item)
+{
+	return vec_mpmc_pop_n(self, item, 1) == 1;
+}
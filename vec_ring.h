@@ -0,0 +1,154 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (c) 2025 Andrea Cervesato <andrea.cervesato@mailbox.org>
+ */
+
+#ifndef LIBVEST_VEC_RING_H
+#define LIBVEST_VEC_RING_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+/** @brief A bounded single-producer single-consumer queue.
+ *
+ * Items of the same size are stored inside a ring buffer. One thread can
+ * push items while another one pops them, without locks.
+ */
+typedef struct vec_spsc_obj* vec_spsc_t;
+
+/** @brief A bounded multi-producer multi-consumer queue.
+ *
+ * Items of the same size are stored inside a ring buffer where each slot has
+ * a sequence number telling if it can be written or read, so any number of
+ * threads can push and pop items without locks.
+ */
+typedef struct vec_mpmc_obj* vec_mpmc_t;
+
+/** @brief Create a new single-producer single-consumer queue.
+ *
+ * @param unit_size Size of a single item.
+ * @param capacity Minimum number of items, rounded up to a power of two.
+ * @return New queue.
+ */
+vec_spsc_t vec_spsc_new(const size_t unit_size, const size_t capacity);
+
+/** @brief Release the queue memory. */
+void vec_spsc_free(vec_spsc_t self);
+
+/** @brief Return the maximum number of items inside the queue.
+ *
+ * @param self Queue object.
+ * @return Capacity of the queue.
+ */
+size_t vec_spsc_capacity(const vec_spsc_t self) __attribute__((pure));
+
+/** @brief Return the number of items inside the queue.
+ *
+ * The value can be outdated as soon as it's returned, if the other thread
+ * is using the queue.
+ *
+ * @param self Queue object.
+ * @return Number of items.
+ */
+size_t vec_spsc_count(const vec_spsc_t self);
+
+/** @brief Push an `item` inside the queue. Producer only.
+ *
+ * @param self Queue object.
+ * @param item Pointer to the item.
+ * @return False if the queue is full, true otherwise.
+ */
+bool vec_spsc_push(vec_spsc_t self, const void *item);
+
+/** @brief Pop an item from the queue. Consumer only.
+ *
+ * @param self Queue object.
+ * @param item The item is copied here.
+ * @return False if the queue is empty, true otherwise.
+ */
+bool vec_spsc_pop(vec_spsc_t self, void *item);
+
+/** @brief Push up to `len` consecutive items inside the queue. Producer only.
+ *
+ * @param self Queue object.
+ * @param items Pointer to the items.
+ * @param len Number of items.
+ * @return Number of pushed items.
+ */
+size_t vec_spsc_push_n(vec_spsc_t self, const void *items, const size_t len);
+
+/** @brief Pop up to `len` items from the queue. Consumer only.
+ *
+ * @param self Queue object.
+ * @param items The items are copied here.
+ * @param len Maximum number of items.
+ * @return Number of popped items.
+ */
+size_t vec_spsc_pop_n(vec_spsc_t self, void *items, const size_t len);
+
+/** @brief Create a new multi-producer multi-consumer queue.
+ *
+ * @param unit_size Size of a single item.
+ * @param capacity Minimum number of items, rounded up to a power of two.
+ * @return New queue.
+ */
+vec_mpmc_t vec_mpmc_new(const size_t unit_size, const size_t capacity);
+
+/** @brief Release the queue memory. */
+void vec_mpmc_free(vec_mpmc_t self);
+
+/** @brief Return the maximum number of items inside the queue.
+ *
+ * @param self Queue object.
+ * @return Capacity of the queue.
+ */
+size_t vec_mpmc_capacity(const vec_mpmc_t self) __attribute__((pure));
+
+/** @brief Return the number of items inside the queue.
+ *
+ * The value can be outdated as soon as it's returned, if other threads are
+ * using the queue.
+ *
+ * @param self Queue object.
+ * @return Number of items.
+ */
+size_t vec_mpmc_count(const vec_mpmc_t self);
+
+/** @brief Push an `item` inside the queue.
+ *
+ * @param self Queue object.
+ * @param item Pointer to the item.
+ * @return False if the queue is full, true otherwise.
+ */
+bool vec_mpmc_push(vec_mpmc_t self, const void *item);
+
+/** @brief Pop an item from the queue.
+ *
+ * @param self Queue object.
+ * @param item The item is copied here.
+ * @return False if the queue is empty, true otherwise.
+ */
+bool vec_mpmc_pop(vec_mpmc_t self, void *item);
+
+/** @brief Push up to `len` consecutive items inside the queue.
+ *
+ * The pushed items are consecutive inside the queue, even if other threads
+ * are pushing at the same time.
+ *
+ * @param self Queue object.
+ * @param items Pointer to the items.
+ * @param len Number of items.
+ * @return Number of pushed items.
+ */
+size_t vec_mpmc_push_n(vec_mpmc_t self, const void *items, const size_t len);
+
+/** @brief Pop up to `len` consecutive items from the queue.
+ *
+ * @param self Queue object.
+ * @param items The items are copied here.
+ * @param len Maximum number of items.
+ * @return Number of popped items.
+ */
+size_t vec_mpmc_pop_n(vec_mpmc_t self, void *items, const size_t len);
+
+#endif
@@ -0,0 +1,225 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (c) 2025 Andrea Cervesato <andrea.cervesato@mailbox.org>
+ */
+
+#include "vec_seg.h"
+#include "vec_priv.h"
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include <stdint.h>
+
+/* Segment `k` holds `1 << (VEC_SEG_SHIFT + k)` items, so the items before it
+ * are `(1 << (VEC_SEG_SHIFT + k)) - (1 << VEC_SEG_SHIFT)`.
+ */
+#define SEG_FIRST ((size_t)1 << VEC_SEG_SHIFT)
+#define SEG_MAX (sizeof(size_t) * 8 - VEC_SEG_SHIFT)
+
+struct vec_seg_obj
+{
+	size_t unit_size;
+	size_t count;
+	size_t segments;	/* number of allocated segments */
+	uint8_t *seg[SEG_MAX];
+};
+
+static inline size_t seg_len(const size_t k)
+{
+	return SEG_FIRST << k;
+}
+
+static inline size_t seg_capacity(const size_t segments)
+{
+	return segments ? seg_len(segments) - SEG_FIRST : 0;
+}
+
+vec_seg_t vec_seg_new(const size_t unit_size)
+{
+	vec_seg_t self = calloc(1, sizeof(struct vec_seg_obj));
+	if (!self)
+		return NULL;
+
+	self->unit_size = unit_size;
+
+	return self;
+}
+
+void vec_seg_free(vec_seg_t self)
+{
+	assert(self);
+
+	for (size_t k = 0; k < self->segments; k++)
+		free(self->seg[k]);
+
+	free(self);
+}
+
+size_t vec_seg_unit_size(const vec_seg_t self)
+{
+	assert(self);
+	return self->unit_size;
+}
+
+size_t vec_seg_count(const vec_seg_t self)
+{
+	assert(self);
+	return self->count;
+}
+
+size_t vec_seg_capacity(const vec_seg_t self)
+{
+	assert(self);
+	return seg_capacity(self->segments);
+}
+
+/* set to zero the items in [start, end) */
+static void seg_zero(vec_seg_t self, size_t start, const size_t end)
+{
+	while (start < end) {
+		size_t off;
+		size_t k = vec_seg_locate(start, VEC_SEG_SHIFT, &off);
+
+		size_t len = seg_len(k) - off;
+		if (len > end - start)
+			len = end - start;
+
+		memset(self->seg[k] + off * self->unit_size, 0,
+			len * self->unit_size);
+		start += len;
+	}
+}
+
+bool vec_seg_resize(vec_seg_t self, const size_t count)
+{
+	assert(self);
+
+	if (count > SIZE_MAX - SEG_FIRST)
+		return false;
+
+	size_t reused = seg_capacity(self->segments);
+
+	while (count > seg_capacity(self->segments)) {
+		size_t k = self->segments;
+
+		if (self->unit_size > SIZE_MAX / seg_len(k))
+			return false;
+
+		self->seg[k] = calloc(seg_len(k), self->unit_size);
+		if (!self->seg[k])
+			return false;
+
+		self->segments++;
+	}
+
+	/* new segments come zeroed, reused ones must be cleared */
+	if (count > self->count && reused > self->count)
+		seg_zero(self, self->count, count < reused ? count : reused);
+
+	self->count = count;
+
+	return true;
+}
+
+bool vec_seg_extend(vec_seg_t self, const size_t count)
+{
+	assert(self);
+
+	if (self->count > SIZE_MAX - count)
+		return false;
+
+	return vec_seg_resize(self, self->count + count);
+}
+
+void *vec_seg_ptr_at(const vec_seg_t self, const size_t pos)
+{
+	assert(self);
+
+	if (pos >= self->count)
+		return NULL;
+
+	size_t off;
+	size_t k = vec_seg_locate(pos, VEC_SEG_SHIFT, &off);
+
+	return self->seg[k] + off * self->unit_size;
+}
+
+bool vec_seg_set(vec_seg_t self, const size_t pos, const void *item)
+{
+	assert(item);
+
+	void *ptr = vec_seg_ptr_at(self, pos);
+	if (!ptr)
+		return false;
+
+	memcpy(ptr, item, self->unit_size);
+
+	return true;
+}
+
+bool vec_seg_get(const vec_seg_t self, const size_t pos, void *item)
+{
+	assert(item);
+
+	void *ptr = vec_seg_ptr_at(self, pos);
+	if (!ptr)
+		return false;
+
+	memcpy(item, ptr, self->unit_size);
+
+	return true;
+}
+
+bool vec_seg_push(vec_seg_t self, const void *item)
+{
+	assert(self);
+	assert(item);
+
+	size_t pos = self->count;
+
+	if (pos < seg_capacity(self->segments))
+		self->count++;
+	else if (!vec_seg_resize(self, pos + 1))
+		return false;
+
+	memcpy(vec_seg_ptr_at(self, pos), item, self->unit_size);
+
+	return true;
+}
+
+bool vec_seg_pop(vec_seg_t self, void *item)
+{
+	assert(self);
+
+	if (!self->count)
+		return false;
+
+	if (item)
+		memcpy(item, vec_seg_ptr_at(self, self->count - 1),
+			self->unit_size);
+
+	self->count--;
+
+	return true;
+}
+
+void *vec_seg_next(const vec_seg_t self, size_t *iter, size_t *len)
+{
+	assert(self);
+	assert(iter);
+	assert(len);
+
+	size_t k = *iter;
+	size_t start = seg_capacity(k);
+
+	if (k >= self->segments || start >= self->count)
+		return NULL;
+
+	*len = self->count - start;
+	if (*len > seg_len(k))
+		*len = seg_len(k);
+
+	(*iter)++;
+
+	return self->seg[k];
+}
@@ -0,0 +1,129 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (c) 2025 Andrea Cervesato <andrea.cervesato@mailbox.org>
+ */
+
+#ifndef LIBVEST_VEC_SEG_H
+#define LIBVEST_VEC_SEG_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+/** @brief Number of items inside the first segment, as a power of two. */
+#define VEC_SEG_SHIFT 6
+
+/** @brief An abstract segmented vector.
+ *
+ * A segmented vector stores its items inside segments which are never moved.
+ * The first segment holds `1 << VEC_SEG_SHIFT` items and every new segment
+ * doubles the capacity, so growth never copies the items and pointers to
+ * them stay valid until the vector is shrunk below their position or freed.
+ */
+typedef struct vec_seg_obj* vec_seg_t;
+
+/** @brief Create a new segmented vector.
+ *
+ * @param unit_size Size of a single item.
+ * @return New segmented vector.
+ */
+vec_seg_t vec_seg_new(const size_t unit_size);
+
+/** @brief Release the segmented vector memory. */
+void vec_seg_free(vec_seg_t self);
+
+/** @brief Return the size of a single item.
+ *
+ * @param self Segmented vector object.
+ * @return Single item size.
+ */
+size_t vec_seg_unit_size(const vec_seg_t self) __attribute__((pure));
+
+/** @brief Return the number of items inside the segmented vector.
+ *
+ * @param self Segmented vector object.
+ * @return Number of items.
+ */
+size_t vec_seg_count(const vec_seg_t self) __attribute__((pure));
+
+/** @brief Return the number of items the allocated segments can hold.
+ *
+ * @param self Segmented vector object.
+ * @return Capacity of the segmented vector.
+ */
+size_t vec_seg_capacity(const vec_seg_t self) __attribute__((pure));
+
+/** @brief Resize the segmented vector to `count` items.
+ *
+ * New items are set to zero. Segments are kept allocated when the vector
+ * shrinks, so they can be reused later.
+ *
+ * @param self Segmented vector object.
+ * @param count New number of items.
+ * @return True on success. False if memory can't be allocated.
+ */
+bool vec_seg_resize(vec_seg_t self, const size_t count);
+
+/** @brief Extend the segmented vector by `count` items.
+ *
+ * @param self Segmented vector object.
+ * @param count Number of items to add.
+ * @return True on success. False if memory can't be allocated.
+ */
+bool vec_seg_extend(vec_seg_t self, const size_t count);
+
+/** @brief Return the pointer to the item at `pos`.
+ *
+ * @param self Segmented vector object.
+ * @param pos Position of the item.
+ * @return Item pointer or NULL if `pos` is out of bounds.
+ */
+void *vec_seg_ptr_at(const vec_seg_t self, const size_t pos)
+	__attribute__((pure));
+
+/** @brief Set the item at `pos`.
+ *
+ * @param self Segmented vector object.
+ * @param pos Position of the item.
+ * @param item Pointer to the item.
+ * @return False if `pos` is out of bounds, true otherwise.
+ */
+bool vec_seg_set(vec_seg_t self, const size_t pos, const void *item);
+
+/** @brief Copy the item at `pos` inside `item`.
+ *
+ * @param self Segmented vector object.
+ * @param pos Position of the item.
+ * @param item Pointer to the item.
+ * @return False if `pos` is out of bounds, true otherwise.
+ */
+bool vec_seg_get(const vec_seg_t self, const size_t pos, void *item);
+
+/** @brief Append an `item` at the end of the segmented vector.
+ *
+ * @param self Segmented vector object.
+ * @param item Pointer to the item.
+ * @return True on success. False if memory can't be allocated.
+ */
+bool vec_seg_push(vec_seg_t self, const void *item);
+
+/** @brief Remove the last item of the segmented vector.
+ *
+ * @param self Segmented vector object.
+ * @param item If not NULL, the removed item is copied here.
+ * @return False if the vector is empty, true otherwise.
+ */
+bool vec_seg_pop(vec_seg_t self, void *item);
+
+/** @brief Iterate over the segments holding the items.
+ *
+ * Segments are visited in order. `iter` must be set to 0 before the first
+ * call.
+ *
+ * @param self Segmented vector object.
+ * @param iter Iterator position.
+ * @param len Set to the number of items inside the segment.
+ * @return Pointer to the first item of the segment or NULL at the end.
+ */
+void *vec_seg_next(const vec_seg_t self, size_t *iter, size_t *len);
+
+#endif